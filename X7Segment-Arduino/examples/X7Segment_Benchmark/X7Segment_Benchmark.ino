@@ -0,0 +1,132 @@
+#include <X7Segment.h>
+
+// Times every display mode, the text cache, the color helpers and the output stage,
+// for chains of 1 to 64 boards, and prints the results over Serial as CSV so they can
+// be compared between library releases. Boards don't need to be connected.
+
+// GPIO the benchmark displays are created on
+const int DATA_PIN = 10;
+
+// Every test is run this many times and the average is reported. Both can be set from the
+// build - a desktop machine needs far more runs, and more decimals, to get past its 1us micros()
+#ifndef ITERATIONS
+  #define ITERATIONS 200
+#endif
+
+#ifndef REPORT_DECIMALS
+  #define REPORT_DECIMALS 2
+#endif
+
+// Chain lengths to test - boards with little RAM (like an UNO) will need to drop the longer chains
+const int NUM_CHAINS = 7;
+const uint8_t chainLengths[ NUM_CHAINS ] = { 1, 2, 4, 8, 16, 32, 64 };
+
+// Which mode RunMode() is timing
+enum BenchMode { TEXT_HIT, TEXT_MISS, VERTICAL_RAINBOW, HORIZONTAL_RAINBOW, COLOR_CYCLE, TIME };
+const char *modeNames[] = { "DisplayTextColor (cache hit)", "DisplayTextColor (cache miss)", "DisplayTextVerticalRainbow", "DisplayTextHorizontalRainbow", "DisplayTextColorCycle", "DisplayTime" };
+
+void Report( uint8_t boards, const char *test, float microsPerCall )
+{
+  Serial.print( boards );
+  Serial.print( ",\"" );
+  Serial.print( test );
+  Serial.print( "\"," );
+  Serial.print( ITERATIONS );
+  Serial.print( "," );
+  Serial.println( microsPerCall, REPORT_DECIMALS );
+}
+
+// Two different strings as long as the chain, so the cache can be made to hit or miss
+String MakeText( uint8_t boards, char offset )
+{
+  String text = "";
+  for ( int i = 0; i < boards; i++ )
+    text += (char)( '0' + ( ( i + offset ) % 10 ) );
+
+  return text;
+}
+
+void RunMode( X7Segment &disp, uint8_t boards, BenchMode mode )
+{
+  String textA = MakeText( boards, 0 );
+  String textB = MakeText( boards, 1 );
+
+  uint32_t encodeTotal = 0;
+  uint32_t transmitTotal = 0;
+
+  uint32_t start = micros();
+
+  for ( long i = 0; i < ITERATIONS; i++ )
+  {
+    switch( mode )
+    {
+      case TEXT_HIT:            disp.DisplayTextColor( textA, disp.Color(255, 0, 0) ); break;
+      case TEXT_MISS:           disp.DisplayTextColor( ( i & 1 ) ? textA : textB, disp.Color(255, 0, 0) ); break;
+      case VERTICAL_RAINBOW:    disp.DisplayTextVerticalRainbow( textA, disp.Color(255, 0, 0), disp.Color(0, 0, 255) ); break;
+      case HORIZONTAL_RAINBOW:  disp.DisplayTextHorizontalRainbow( textA, disp.Color(255, 0, 0), disp.Color(0, 0, 255) ); break;
+      case COLOR_CYCLE:         disp.DisplayTextColorCycle( textA, i ); break;
+      case TIME:                disp.DisplayTime( 12, 34, i % 60, disp.Color(255, 200, 0), disp.Color(0, 0, 255) ); break;
+    }
+
+    encodeTotal += disp.GetLastEncodeMicros();
+    transmitTotal += disp.GetLastTransmitMicros();
+  }
+
+  Report( boards, modeNames[ mode ], (float)( micros() - start ) / ITERATIONS );
+
+  // The output stage is the same for every mode, so only report it once per chain
+  if ( mode == TEXT_HIT )
+  {
+    Report( boards, "FillBuffer encode", (float)encodeTotal / ITERATIONS );
+    Report( boards, "FillBuffer transmit", (float)transmitTotal / ITERATIONS );
+  }
+}
+
+void RunColorTests()
+{
+  volatile uint32_t sink = 0;
+  uint32_t start = micros();
+
+  for ( long i = 0; i < ITERATIONS; i++ )
+    sink += X7Segment::ColorHSV( i * 327 );
+
+  Report( 0, "ColorHSV", (float)( micros() - start ) / ITERATIONS );
+
+  X7Segment disp( 1, DATA_PIN );
+  start = micros();
+
+  for ( long i = 0; i < ITERATIONS; i++ )
+    sink += disp.Wheel( i );
+
+  Report( 0, "Wheel", (float)( micros() - start ) / ITERATIONS );
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  delay(1000);
+
+  Serial.println( "boards,test,iterations,us_per_call" );
+
+  RunColorTests();
+
+  for ( int c = 0; c < NUM_CHAINS; c++ )
+  {
+    X7Segment *disp = new X7Segment( chainLengths[c], DATA_PIN );
+    disp->Begin(20);
+
+    if ( disp->IsReady() )
+    {
+      for ( int mode = TEXT_HIT; mode <= TIME; mode++ )
+        RunMode( *disp, chainLengths[c], (BenchMode)mode );
+    }
+
+    delete disp;
+  }
+
+  Serial.println( "done" );
+}
+
+void loop()
+{
+}
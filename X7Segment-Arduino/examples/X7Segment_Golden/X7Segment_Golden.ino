@@ -0,0 +1,126 @@
+#include <X7Segment.h>
+
+// Renders every display mode and every character into the frame buffer and checks the
+// CRC of each frame against the golden values below, so any change to the library that
+// alters a single output byte shows up as a FAIL. The boards don't need to be connected.
+//
+// Every case is drawn on a freshly started display, so no case depends on what the one
+// before it left behind. The host tests in extras/host run these same cases and compare
+// them against golden ASCII and PPM images as well.
+
+// Each case uses 5 X7Segment boards connected to GPIO 10
+const uint8_t NUM_BOARDS = 5;
+const uint8_t DATA_PIN = 10;
+
+// Set to true to draw every frame over Serial, not just the ones that fail
+bool showAllFrames = false;
+
+// Golden CRCs for the mode cases, in the same order as the switch in RenderModeCase()
+const int NUM_MODE_CASES = 14;
+const uint32_t goldenModes[ NUM_MODE_CASES ] = {
+  0x156651AE, 0x27D12E3C, 0x90E20DFD, 0xC66000D3, 0x77828BC1, 0xFA119A62, 0x6F6B8E7E, 0x33417669,
+  0x2C37B859, 0xD464099D, 0x9601659C, 0x1372D1E8, 0xFD1C2C45, 0xBC0929F3
+};
+
+// Golden CRCs for every character in the character set, normal then forced uppercase
+const int NUM_GLYPH_CASES = 32;
+const uint32_t goldenGlyphs[ 2 ][ NUM_GLYPH_CASES ] = {
+  {
+    0x5496DF1A, 0x0F0DA91A, 0x34A1C83E, 0x47D3C7B0, 0x4F80715E, 0x7FCD00D4, 0x2D23EDD7, 0x0E2B84F7,
+    0x05365874, 0x4EA65CB3, 0x1D6E9C5D, 0x2D23EDD7, 0x5D1F8834, 0x153D2AB3, 0x0CBF0F5A, 0x14E7CB73,
+    0x4EA65CB3, 0x1C48B1B0, 0x446161F0, 0x449DADDD, 0x5C39A5D9, 0x245676D4, 0x3C0EB2FD, 0x3DD4533D,
+    0x4EA65CB3, 0x04ECB9B4, 0x7FCD00D4, 0x55B0F2F7, 0x1C48B1B0, 0x57D8B577, 0x5724795A, 0x0684FE34
+  },
+  {
+    0x5496DF1A, 0x0F0DA91A, 0x34A1C83E, 0x47D3C7B0, 0x4F80715E, 0x7FCD00D4, 0x2D23EDD7, 0x0E2B84F7,
+    0x05365874, 0x4EA65CB3, 0x1D6E9C5D, 0x05365874, 0x5D1F8834, 0x5496DF1A, 0x0CBF0F5A, 0x14E7CB73,
+    0x4EA65CB3, 0x1C48B1B0, 0x446161F0, 0x449DADDD, 0x5C39A5D9, 0x4CCE1B33, 0x5496DF1A, 0x3DD4533D,
+    0x4EA65CB3, 0x45474C1D, 0x7FCD00D4, 0x55B0F2F7, 0x1C48B1B0, 0x57D8B577, 0x5724795A, 0x0684FE34
+  }
+};
+
+int failures = 0;
+
+void RenderModeCase( X7Segment &disp, int index )
+{
+  switch( index )
+  {
+    case 0:   disp.DisplayTextColor( "12345", disp.Color(255, 10, 3) ); break;
+    case 1:   disp.DisplayTextColor( "1.2.3.", disp.Color(255, 10, 3) ); break;
+    case 2:   disp.DisplayTextColor( ".1234", disp.Color(0, 255, 0) ); break;
+    case 3:   disp.DisplayTextColor( "1..23", disp.Color(0, 255, 0) ); break;
+    case 4:   disp.DisplayTextColor( "123456789", disp.Color(0, 0, 255) ); break;
+    case 5:   disp.DisplayTextVerticalRainbow( "ABCDE", disp.Color(255, 0, 0), disp.Color(0, 0, 255) ); break;
+    case 6:   disp.DisplayTextVerticalRainbow( "8.8.8.", disp.Wheel(20), disp.Wheel(200) ); break;
+    case 7:   disp.DisplayTextHorizontalRainbow( "67890", disp.Wheel(0), disp.Wheel(150) ); break;
+    case 8:   disp.DisplayTextColorCycle( "12345", 0 ); break;
+    case 9:   disp.DisplayTextColorCycle( "0---0", 100 ); break;
+    case 10:  disp.DisplayTime( 22, 16, 0, disp.Color(255, 200, 0), disp.Color(0, 0, 255) ); break;
+    case 11:  disp.DisplayTime( 9, 5, 1, disp.Color(255, 200, 0), disp.Color(0, 0, 255) ); break;
+    case 12:  disp.DisplayTextColor( "hello", disp.ColorHSV(10000, 200, 180) ); break;
+    case 13:
+      disp.ForceUppercase( true );
+      disp.DisplayTextColor( "bdnor", disp.ColorHSV(40000) );
+      break;
+  }
+}
+
+void RenderGlyphCase( X7Segment &disp, bool upper, int index )
+{
+  disp.ForceUppercase( upper );
+  disp.DisplayTextColor( disp.GetCharacterAtArrayIndex(index), disp.Color(255, 255, 255) );
+}
+
+void Check( X7Segment &disp, String name, uint32_t golden )
+{
+  uint32_t crc = disp.GetFrameCRC();
+  bool pass = ( crc == golden );
+
+  if ( !pass )
+    failures++;
+
+  Serial.print( pass ? "PASS " : "FAIL " );
+  Serial.print( name );
+  Serial.print( " 0x" );
+  Serial.println( crc, HEX );
+
+  if ( !pass || showAllFrames )
+    disp.RenderASCII( Serial );
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  delay(1000);
+
+  for ( int i = 0; i < NUM_MODE_CASES; i++ )
+  {
+    X7Segment disp( NUM_BOARDS, DATA_PIN );
+    disp.Begin(20);
+
+    RenderModeCase( disp, i );
+    Check( disp, "mode " + String(i), goldenModes[i] );
+  }
+
+  for ( int upper = 0; upper < 2; upper++ )
+  {
+    for ( int i = 0; i < NUM_GLYPH_CASES; i++ )
+    {
+      X7Segment disp( NUM_BOARDS, DATA_PIN );
+      disp.Begin(20);
+
+      if ( i >= disp.GetArraySize() )
+        break;
+
+      RenderGlyphCase( disp, upper == 1, i );
+      Check( disp, ( upper ? "upper '" : "glyph '" ) + disp.GetCharacterAtArrayIndex(i) + "'", goldenGlyphs[ upper ][i] );
+    }
+  }
+
+  Serial.print( failures );
+  Serial.println( " failures" );
+}
+
+void loop()
+{
+}
@@ -0,0 +1,22 @@
+// ---------------------------------------------------------------------------
+// Created by Seon Rozenblum - seon@unexpectedmaker.com
+// Copyright 2019 License: MIT https://github.com/UnexpectedMaker/X7Segment/LICENSE
+//
+// PURPOSE:
+// Runs the X7Segment_Benchmark example unchanged on the host, against the
+// simulated NeoPixel backend in shim/. Same scenarios and the same CSV on
+// stdout, so results can be kept and compared between releases without a
+// board. The build runs 20000 iterations and reports 4 decimals, as 200 runs
+// of the fastest calls come in under the resolution of micros().
+//
+// SYNTAX:
+//   benchmark_host > results.csv
+// ---------------------------------------------------------------------------
+
+#include "../../examples/X7Segment_Benchmark/X7Segment_Benchmark.ino"
+
+int main()
+{
+	setup();
+	return 0;
+}
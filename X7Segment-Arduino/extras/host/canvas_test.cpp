@@ -0,0 +1,147 @@
+// ---------------------------------------------------------------------------
+// Created by Seon Rozenblum - seon@unexpectedmaker.com
+// Copyright 2019 License: MIT https://github.com/UnexpectedMaker/X7Segment/LICENSE
+//
+// PURPOSE:
+// Checks X7SegmentCanvas hands every lit pixel its own canvas position, for
+// rows of different lengths, and that rows added after Begin() aren't drawn
+// until the coordinate table has been rebuilt for them.
+//
+// SYNTAX:
+//   canvas_test    - Exit code is the number of failures
+// ---------------------------------------------------------------------------
+
+#include <X7SegmentCanvas.h>
+
+#include <stdio.h>
+#include <string>
+
+class StringPrint : public Print
+{
+	public:
+		std::string data;
+		size_t write( uint8_t b ) { data += (char)b; return 1; }
+};
+
+static int failures = 0;
+
+static void Expect( bool ok, const char *what, int a = 0, int b = 0 )
+{
+	if ( !ok && failures++ < 20 )
+		printf( "FAIL %s ( %d, %d )\n", what, a, b );
+}
+
+static uint16_t canvasWidth = 0;
+static uint16_t canvasHeight = 0;
+static uint32_t effectCalls = 0;
+
+// Colors each pixel with where it is, so the output shows which position it was given
+static uint32_t PositionEffect( uint16_t x, uint16_t y, uint16_t width, uint16_t height )
+{
+	Expect( x < width && y < height, "position inside the canvas", x, y );
+	Expect( width == canvasWidth && height == canvasHeight, "canvas size", width, height );
+	effectCalls++;
+
+	return X7Segment::Color( x, y, 1 );
+}
+
+// Every lit pixel in the row's image must carry its own position, offset down by the row
+static uint32_t CheckRow( X7Segment &row, uint8_t rowIndex )
+{
+	StringPrint ppm;
+	row.RenderPPM( ppm, 1 );
+
+	uint16_t width = row.GetDisplayCount() * NUM_COLUMNS_PER_BOARD;
+	const uint8_t *rgb = (const uint8_t *) ppm.data.data() + ppm.data.size() - width * NUM_ROWS_PER_BOARD * 3;
+	uint32_t lit = 0;
+
+	for ( uint16_t y = 0; y < NUM_ROWS_PER_BOARD; y++ )
+	{
+		for ( uint16_t x = 0; x < width; x++, rgb += 3 )
+		{
+			if ( rgb[0] == 0 && rgb[1] == 0 && rgb[2] == 0 )
+				continue;
+
+			Expect( rgb[0] == x && rgb[1] == y + rowIndex * NUM_ROWS_PER_BOARD && rgb[2] == 1, "pixel colored with its canvas position", x, y + rowIndex * NUM_ROWS_PER_BOARD );
+			lit++;
+		}
+	}
+
+	return lit;
+}
+
+int main()
+{
+	// Rows of different lengths, the canvas is as wide as the longest
+	{
+		X7Segment top( 3, 4 );
+		X7Segment middle( 5, 5 );
+		X7Segment bottom( 1, 6 );
+		top.Begin(255);
+		middle.Begin(255);
+		bottom.Begin(255);
+
+		X7SegmentCanvas canvas;
+		canvas.AddRow( top );
+		canvas.AddRow( middle );
+		canvas.AddRow( bottom );
+		Expect( canvas.Begin(), "begin" );
+
+		canvasWidth = 5 * NUM_COLUMNS_PER_BOARD;
+		canvasHeight = 3 * NUM_ROWS_PER_BOARD;
+		Expect( canvas.GetWidth() == canvasWidth && canvas.GetHeight() == canvasHeight, "size", canvas.GetWidth(), canvas.GetHeight() );
+
+		// 14 segment pixels for an 8, and the decimal point for the '.'
+		canvas.SetRowText( 0, "888" );
+		canvas.SetRowText( 1, "8.8.8.8.8." );
+		canvas.SetRowText( 2, "1" );
+
+		effectCalls = 0;
+		canvas.Render( PositionEffect );
+
+		Expect( CheckRow( top, 0 ) == 3 * 14, "top row lit pixels" );
+		Expect( CheckRow( middle, 1 ) == 5 * 15, "middle row lit pixels" );
+		Expect( CheckRow( bottom, 2 ) == 4, "bottom row lit pixels" );
+		Expect( effectCalls == 3 * 14 + 5 * 15 + 4, "effect called once per lit pixel", effectCalls );
+	}
+
+	// A row added after Begin() isn't covered by the table, so nothing is drawn until Begin() again
+	{
+		X7Segment first( 2, 4 );
+		X7Segment second( 5, 5 );
+		first.Begin(255);
+		second.Begin(255);
+
+		X7SegmentCanvas canvas;
+		canvas.AddRow( first );
+		Expect( canvas.Begin(), "begin with one row" );
+
+		canvas.AddRow( second );
+		canvas.SetRowText( 0, "88" );
+		canvas.SetRowText( 1, "88888" );
+
+		effectCalls = 0;
+		canvas.Render( PositionEffect );
+		Expect( effectCalls == 0, "stale table isn't drawn with", effectCalls );
+
+		Expect( canvas.Begin(), "begin again with both rows" );
+		canvasWidth = 5 * NUM_COLUMNS_PER_BOARD;
+		canvasHeight = 2 * NUM_ROWS_PER_BOARD;
+
+		canvas.Render( PositionEffect );
+		Expect( CheckRow( first, 0 ) == 2 * 14, "first row after rebuild" );
+		Expect( CheckRow( second, 1 ) == 5 * 14, "second row after rebuild" );
+
+		// A row that isn't ready makes Begin() fail, and leaves nothing to draw with
+		X7Segment notBegun( 4, 6 );
+		canvas.AddRow( notBegun );
+		Expect( !canvas.Begin(), "begin fails with a row that isn't ready" );
+
+		effectCalls = 0;
+		canvas.Render( PositionEffect );
+		Expect( effectCalls == 0, "failed begin isn't drawn with", effectCalls );
+	}
+
+	printf( "%d failures\n", failures );
+	return failures;
+}
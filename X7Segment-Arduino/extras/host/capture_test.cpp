@@ -0,0 +1,330 @@
+// ---------------------------------------------------------------------------
+// Created by Seon Rozenblum - seon@unexpectedmaker.com
+// Copyright 2019 License: MIT https://github.com/UnexpectedMaker/X7Segment/LICENSE
+//
+// PURPOSE:
+// Round trips frames through X7SegmentCapture and X7SegmentReplay. Covers skip,
+// repeat and literal runs up to and past the 64 LED limit, brightness changes,
+// reading a version 1 log, rejecting bad headers, Diff() and Play().
+//
+// SYNTAX:
+//   capture_test    - Exit code is the number of failures
+// ---------------------------------------------------------------------------
+
+#include <X7SegmentCapture.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+// A log in memory, written by a capture and read back by a replay
+class MemoryStream : public Stream
+{
+	public:
+		MemoryStream() : pos( 0 ) {}
+		MemoryStream( const std::string &bytes ) : data( bytes ), pos( 0 ) {}
+
+		size_t write( uint8_t b ) { data += (char)b; return 1; }
+		int available() { return data.size() - pos; }
+		int read() { return ( pos < data.size() ) ? (uint8_t)data[ pos++ ] : -1; }
+		int peek() { return ( pos < data.size() ) ? (uint8_t)data[ pos ] : -1; }
+
+		std::string data;
+		size_t pos;
+};
+
+static int failures = 0;
+
+static void Expect( bool ok, const char *what, int a = 0, int b = 0 )
+{
+	if ( !ok && failures++ < 20 )
+		printf( "FAIL %s ( %d, %d )\n", what, a, b );
+}
+
+typedef std::vector<uint32_t> Frame;
+
+const uint16_t LEDS = 200;
+
+// Frames that hit each kind of run, at and either side of the 64 LED limit
+static void BuildFrames( std::vector<Frame> &frames, std::vector<uint8_t> &brightness )
+{
+	Frame f( LEDS, 0 );
+
+	// All black, which is the same as the starting frame, so it is all skips
+	frames.push_back( f ); brightness.push_back( 20 );
+
+	// Every LED different - literal runs of 64, 64, 64 and 8
+	for ( uint16_t i = 0; i < LEDS; i++ )
+		f[i] = X7Segment::Color( i, 255 - i, i * 7 );
+	frames.push_back( f ); brightness.push_back( 20 );
+
+	// Nothing changed, but the brightness did
+	frames.push_back( f ); brightness.push_back( 200 );
+
+	// One color everywhere - repeat runs of 64, 64, 64 and 8
+	for ( uint16_t i = 0; i < LEDS; i++ )
+		f[i] = X7Segment::Color( 10, 20, 30 );
+	frames.push_back( f ); brightness.push_back( 200 );
+
+	// Runs of exactly 64 and 65 of each kind, in a row
+	uint16_t i = 0;
+	for ( uint16_t n = 0; n < 64; n++, i++ )
+		f[i] = X7Segment::Color( 1, 2, 3 );
+	for ( uint16_t n = 0; n < 65; n++, i++ )
+		f[i] = X7Segment::Color( n, 0, 255 );
+	i += 65;
+	for ( ; i < LEDS; i++ )
+		f[i] = X7Segment::Color( 0, i, 0 );
+	frames.push_back( f ); brightness.push_back( 0 );
+
+	// Pairs of equal LEDs inside a literal run, and single changes between skips
+	for ( uint16_t n = 0; n < LEDS; n += 3 )
+		f[n] = X7Segment::Color( n / 3, n / 3, 0 );
+	frames.push_back( f ); brightness.push_back( 255 );
+
+	// Random frames, each made of random runs on top of the last one
+	srand( 1234 );
+	for ( int round = 0; round < 300; round++ )
+	{
+		for ( uint16_t n = 0; n < LEDS; )
+		{
+			uint16_t run = rand() % 90 + 1;
+			int kind = rand() % 3;
+			uint32_t col = X7Segment::Color( rand(), rand(), rand() );
+
+			for ( ; run > 0 && n < LEDS; run--, n++ )
+			{
+				if ( kind == 1 )
+					f[n] = col;
+				else if ( kind == 2 )
+					f[n] = X7Segment::Color( rand(), rand(), rand() );
+			}
+		}
+
+		frames.push_back( f );
+		brightness.push_back( ( rand() % 4 == 0 ) ? rand() : brightness.back() );
+	}
+}
+
+static void WriteLog( MemoryStream &log, const std::vector<Frame> &frames, const std::vector<uint8_t> &brightness )
+{
+	X7SegmentCapture capture( log );
+
+	for ( size_t f = 0; f < frames.size(); f++ )
+		capture.Capture( frames[f].data(), LEDS, brightness[f] );
+
+	Expect( capture.GetFrameCount() == frames.size(), "frame count", capture.GetFrameCount() );
+	Expect( capture.GetBytesWritten() == log.data.size(), "bytes written", capture.GetBytesWritten() );
+}
+
+static void CheckRoundTrip()
+{
+	std::vector<Frame> frames;
+	std::vector<uint8_t> brightness;
+	BuildFrames( frames, brightness );
+
+	MemoryStream log;
+	WriteLog( log, frames, brightness );
+
+	X7SegmentReplay replay( log );
+	Expect( replay.Begin(), "begin" );
+	Expect( replay.GetLedCount() == LEDS, "led count", replay.GetLedCount() );
+
+	size_t f = 0;
+	while ( replay.ReadFrame() )
+	{
+		Expect( f < frames.size(), "no extra frames", f );
+		if ( f >= frames.size() )
+			break;
+
+		Expect( memcmp( replay.GetFrame(), frames[f].data(), LEDS * sizeof(uint32_t) ) == 0, "frame matches", f );
+		Expect( replay.GetBrightness() == brightness[f], "brightness matches", f, replay.GetBrightness() );
+		f++;
+	}
+
+	Expect( f == frames.size(), "every frame read back", f );
+	Expect( log.pos == log.data.size(), "whole log read", log.pos );
+}
+
+// An unchanged frame costs the delay byte and one skip per 64 LEDs, and a brightness change 2 bytes more
+static void CheckSize()
+{
+	Frame f( LEDS, X7Segment::Color( 9, 9, 9 ) );
+	MemoryStream log;
+	X7SegmentCapture capture( log );
+
+	capture.Capture( f.data(), LEDS, 50 );
+	uint32_t before = capture.GetBytesWritten();
+	capture.Capture( f.data(), LEDS, 50 );
+	Expect( capture.GetBytesWritten() - before == 1 + 4, "unchanged frame size", capture.GetBytesWritten() - before );
+
+	before = capture.GetBytesWritten();
+	capture.Capture( f.data(), LEDS, 51 );
+	Expect( capture.GetBytesWritten() - before == 1 + 2 + 4, "brightness change size", capture.GetBytesWritten() - before );
+
+	// A frame of a different size is ignored
+	before = capture.GetBytesWritten();
+	capture.Capture( f.data(), LEDS - 1, 51 );
+	Expect( capture.GetBytesWritten() == before && capture.GetFrameCount() == 3, "other sized frame ignored" );
+}
+
+// Written by hand as a version 1 capture would have, with no brightness tokens
+static void CheckVersion1()
+{
+	std::string v1 = std::string( "X7L" ) + (char)1 + (char)70 + (char)0;
+
+	// Frame 1 - 64 LEDs of one color, then 6 literal LEDs
+	v1 += (char)5;
+	v1 += (char)( X7SEGMENT_LOG_REPEAT | 63 ); v1 += (char)1; v1 += (char)2; v1 += (char)3;
+	v1 += (char)( X7SEGMENT_LOG_LITERAL | 5 );
+	for ( int i = 0; i < 6; i++ )
+	{
+		v1 += (char)i; v1 += (char)( i * 2 ); v1 += (char)( i * 3 );
+	}
+
+	// Frame 2 - a delay of 300ms as a 2 byte varint, skip 64, then change the last 6 to one color
+	v1 += (char)( 0x80 | ( 300 & 0x7F ) ); v1 += (char)( 300 >> 7 );
+	v1 += (char)( X7SEGMENT_LOG_SKIP | 63 );
+	v1 += (char)( X7SEGMENT_LOG_REPEAT | 5 ); v1 += (char)0xFF; v1 += (char)0; v1 += (char)0x80;
+
+	MemoryStream log( v1 );
+	X7SegmentReplay replay( log );
+	Expect( replay.Begin() && replay.GetLedCount() == 70, "version 1 header" );
+
+	Expect( replay.ReadFrame(), "version 1 frame 1" );
+	Expect( replay.GetFrameDelay() == 5 && replay.GetBrightness() == 255, "version 1 frame 1 delay and brightness", replay.GetFrameDelay(), replay.GetBrightness() );
+	Expect( replay.GetFrame()[0] == X7Segment::Color( 1, 2, 3 ) && replay.GetFrame()[63] == X7Segment::Color( 1, 2, 3 ), "version 1 repeat run" );
+	Expect( replay.GetFrame()[69] == X7Segment::Color( 5, 10, 15 ), "version 1 literal run" );
+
+	Expect( replay.ReadFrame(), "version 1 frame 2" );
+	Expect( replay.GetFrameDelay() == 300, "version 1 varint delay", replay.GetFrameDelay() );
+	Expect( replay.GetFrame()[63] == X7Segment::Color( 1, 2, 3 ) && replay.GetFrame()[64] == X7Segment::Color( 255, 0, 128 ), "version 1 skip then repeat" );
+
+	Expect( !replay.ReadFrame(), "version 1 end of log" );
+
+	// Newer versions, and anything that isn't a log, are refused
+	MemoryStream future( std::string( "X7L" ) + (char)( X7SEGMENT_LOG_VERSION + 1 ) + (char)70 + (char)0 );
+	X7SegmentReplay futureReplay( future );
+	Expect( !futureReplay.Begin(), "newer version refused" );
+
+	MemoryStream junk( "not a log" );
+	X7SegmentReplay junkReplay( junk );
+	Expect( !junkReplay.Begin(), "bad header refused" );
+
+	// A run past the end of the frame is an error, not an overflow
+	std::string overrun = std::string( "X7L" ) + (char)2 + (char)10 + (char)0;
+	overrun += (char)0; overrun += (char)( X7SEGMENT_LOG_SKIP | 20 );
+	MemoryStream overrunLog( overrun );
+	X7SegmentReplay overrunReplay( overrunLog );
+	Expect( overrunReplay.Begin() && !overrunReplay.ReadFrame(), "run past the end refused" );
+}
+
+static int32_t DiffLogs( MemoryStream &a, MemoryStream &b )
+{
+	MemoryStream readA( a.data );
+	MemoryStream readB( b.data );
+	X7SegmentReplay replayA( readA );
+	X7SegmentReplay replayB( readB );
+
+	if ( !replayA.Begin() || !replayB.Begin() )
+		return -2;
+
+	return replayA.Diff( replayB );
+}
+
+static void CheckDiff()
+{
+	std::vector<Frame> frames;
+	std::vector<uint8_t> brightness;
+	BuildFrames( frames, brightness );
+
+	MemoryStream same, alsoSame;
+	WriteLog( same, frames, brightness );
+	WriteLog( alsoSame, frames, brightness );
+	Expect( DiffLogs( same, alsoSame ) == -1, "identical logs", DiffLogs( same, alsoSame ) );
+
+	// One LED changed
+	std::vector<Frame> ledChanged = frames;
+	ledChanged[ 100 ][ 150 ] ^= 1;
+	MemoryStream ledLog;
+	WriteLog( ledLog, ledChanged, brightness );
+	Expect( DiffLogs( same, ledLog ) == 100, "led difference found", DiffLogs( same, ledLog ) );
+
+	// Only the brightness changed
+	std::vector<uint8_t> brightnessChanged = brightness;
+	brightnessChanged[ 42 ] ^= 1;
+	MemoryStream brightLog;
+	WriteLog( brightLog, frames, brightnessChanged );
+	Expect( DiffLogs( same, brightLog ) == 42, "brightness difference found", DiffLogs( same, brightLog ) );
+
+	// One log runs longer than the other
+	std::vector<Frame> shorter( frames.begin(), frames.end() - 1 );
+	std::vector<uint8_t> shorterBrightness( brightness.begin(), brightness.end() - 1 );
+	MemoryStream shortLog;
+	WriteLog( shortLog, shorter, shorterBrightness );
+	Expect( DiffLogs( same, shortLog ) == (int32_t)shorter.size(), "extra frame found", DiffLogs( same, shortLog ) );
+}
+
+// Playing a capture through a display that is itself captured must give back the same log
+static void CheckPlay()
+{
+	MemoryStream original;
+	uint32_t originalFrames;
+	{
+		X7SegmentCapture capture( original );
+		X7Segment disp( 5, 10 );
+		disp.Begin(20);
+		disp.SetCapture( &capture );
+
+		disp.DisplayTextColor( "12345", X7Segment::Color( 255, 0, 0 ) );
+		disp.DisplayTextVerticalRainbow( "8.8.8.", X7Segment::Color( 255, 0, 0 ), X7Segment::Color( 0, 0, 255 ) );
+		disp.SetBrightness( 100 );
+		disp.DisplayTime( 12, 34, 56, X7Segment::Color( 255, 200, 0 ), X7Segment::Color( 0, 0, 255 ) );
+		disp.SetBrightness( 5 );
+		disp.DisplayTextColorCycle( "HELLO", 40 );
+
+		originalFrames = capture.GetFrameCount();
+		disp.SetCapture( NULL );
+	}
+
+	MemoryStream replayed;
+	{
+		MemoryStream in( original.data );
+		X7SegmentReplay replay( in );
+		Expect( replay.Begin(), "play begin" );
+
+		X7SegmentCapture capture( replayed );
+		X7Segment disp( 5, 10 );
+		disp.Begin(20);
+		disp.SetFrameGovernor( true );
+		disp.SetCapture( &capture );
+
+		uint32_t frames = replay.Play( disp, false );
+		Expect( frames == originalFrames && frames == 4, "frames played", frames, originalFrames );
+		Expect( capture.GetFrameCount() == frames, "every played frame sent", capture.GetFrameCount(), frames );
+
+		disp.SetCapture( NULL );
+	}
+
+	Expect( DiffLogs( original, replayed ) == -1, "played log matches the original", DiffLogs( original, replayed ) );
+
+	// A display of another size can't play the log
+	MemoryStream in( original.data );
+	X7SegmentReplay replay( in );
+	X7Segment other( 4, 10 );
+	other.Begin(20);
+	Expect( replay.Begin() && replay.Play( other, false ) == 0, "other sized display refused" );
+}
+
+int main()
+{
+	CheckRoundTrip();
+	CheckSize();
+	CheckVersion1();
+	CheckDiff();
+	CheckPlay();
+
+	printf( "%d failures\n", failures );
+	return failures;
+}
@@ -0,0 +1,137 @@
+// ---------------------------------------------------------------------------
+// Created by Seon Rozenblum - seon@unexpectedmaker.com
+// Copyright 2019 License: MIT https://github.com/UnexpectedMaker/X7Segment/LICENSE
+//
+// PURPOSE:
+// Checks the table driven ColorHSV(), Wheel(), ColorHSVRamp() and WheelRamp()
+// against the branch ladder versions they replaced, kept here as the reference.
+//
+// SYNTAX:
+//   color_test    - Exit code is the number of failures
+// ---------------------------------------------------------------------------
+
+#include <X7Segment.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// ColorHSV() as it was before the hue table
+static uint32_t OldColorHSV( uint16_t hue, uint8_t sat, uint8_t val )
+{
+	uint8_t r, g, b;
+
+	hue = (hue * 1530L + 32768) / 65536;
+
+	if(hue < 510) {
+		b = 0;
+		if(hue < 255) {
+			r = 255;
+			g = hue;
+		} else {
+			r = 510 - hue;
+			g = 255;
+		}
+	} else if(hue < 1020) {
+		r = 0;
+		if(hue <  765) {
+			g = 255;
+			b = hue - 510;
+		} else {
+			g = 1020 - hue;
+			b = 255;
+		}
+	} else if(hue < 1530) {
+		g = 0;
+		if(hue < 1275) {
+			r = hue - 1020;
+			b = 255;
+		} else {
+			r = 255;
+			b = 1530 - hue;
+		}
+	} else {
+		r = 255;
+		g = b = 0;
+	}
+
+	uint32_t v1 =   1 + val;
+	uint16_t s1 =   1 + sat;
+	uint8_t  s2 = 255 - sat;
+	return ((((((r * s1) >> 8) + s2) * v1) & 0xff00) << 8) |
+			(((((g * s1) >> 8) + s2) * v1) & 0xff00)       |
+		   ( ((((b * s1) >> 8) + s2) * v1)           >> 8);
+}
+
+// Wheel() as it was before the wheel table
+static uint32_t OldWheel( byte WheelPos )
+{
+	WheelPos = 255 - WheelPos;
+	if(WheelPos < 85)
+		return X7Segment::Color(255 - WheelPos * 3, 0, WheelPos * 3);
+
+	if(WheelPos < 170)
+	{
+		WheelPos -= 85;
+		return X7Segment::Color(0, WheelPos * 3, 255 - WheelPos * 3);
+	}
+
+	WheelPos -= 170;
+	return X7Segment::Color(WheelPos * 3, 255 - WheelPos * 3, 0);
+}
+
+static int failures = 0;
+
+static void Expect( bool ok, const char *what, long a, long b, long c )
+{
+	if ( !ok && failures++ < 10 )
+		printf( "FAIL %s ( %ld, %ld, %ld )\n", what, a, b, c );
+}
+
+int main()
+{
+	// Every hue at every saturation, for values across the range and at both ends
+	const uint8_t values[] = { 0, 1, 2, 63, 64, 127, 128, 191, 254, 255 };
+
+	for ( uint8_t v = 0; v < sizeof(values); v++ )
+	{
+		for ( uint16_t sat = 0; sat < 256; sat++ )
+		{
+			for ( uint32_t hue = 0; hue < 65536; hue++ )
+				Expect( X7Segment::ColorHSV( hue, sat, values[v] ) == OldColorHSV( hue, sat, values[v] ), "ColorHSV", hue, sat, values[v] );
+		}
+	}
+
+	X7Segment disp( 1, 0 );
+	for ( uint16_t pos = 0; pos < 256; pos++ )
+		Expect( disp.Wheel( pos ) == OldWheel( pos ), "Wheel", pos, 0, 0 );
+
+	// Ramps must match stepping the single color calls, including wrapping past either end of the hue
+	uint32_t ramp[ 300 ];
+	srand( 1234 );
+
+	for ( int round = 0; round < 20000; round++ )
+	{
+		uint16_t count = rand() % 300 + 1;
+		uint16_t hue = ( round < 4 ) ? (uint16_t)( 65536 - round * 100 ) : rand();
+		int16_t step = ( round < 4 ) ? ( ( round & 1 ) ? -1 : 257 ) : (int16_t)rand();
+		uint8_t sat = ( round % 3 == 0 ) ? 255 : rand();
+		uint8_t val = ( round % 5 == 0 ) ? 255 : rand();
+
+		X7Segment::ColorHSVRamp( ramp, count, hue, step, sat, val );
+
+		uint16_t h = hue;
+		for ( uint16_t i = 0; i < count; i++, h += step )
+			Expect( ramp[i] == OldColorHSV( h, sat, val ), "ColorHSVRamp", round, i, h );
+
+		uint8_t start = rand();
+		uint8_t wheelStep = rand();
+		X7Segment::WheelRamp( ramp, count, start, wheelStep );
+
+		uint8_t w = start;
+		for ( uint16_t i = 0; i < count; i++, w += wheelStep )
+			Expect( ramp[i] == OldWheel( w ), "WheelRamp", round, i, w );
+	}
+
+	printf( "%d failures\n", failures );
+	return failures;
+}
@@ -0,0 +1,140 @@
+// ---------------------------------------------------------------------------
+// Created by Seon Rozenblum - seon@unexpectedmaker.com
+// Copyright 2019 License: MIT https://github.com/UnexpectedMaker/X7Segment/LICENSE
+//
+// PURPOSE:
+// Checks FadeTo(), FadeText() and Pulse() follow their durations, including
+// ones far longer than a minute, like an idle screen fading out. The clock is
+// moved on with AdvanceClock(), and the brightness of every frame sent is read
+// back from a capture of the display.
+//
+// SYNTAX:
+//   fade_test    - Exit code is the number of failures
+// ---------------------------------------------------------------------------
+
+#include <X7SegmentCapture.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+
+// A log in memory, written by a capture and read back by a replay
+class MemoryStream : public Stream
+{
+	public:
+		MemoryStream() : pos( 0 ) {}
+		MemoryStream( const std::string &bytes ) : data( bytes ), pos( 0 ) {}
+
+		size_t write( uint8_t b ) { data += (char)b; return 1; }
+		int available() { return data.size() - pos; }
+		int read() { return ( pos < data.size() ) ? (uint8_t)data[ pos++ ] : -1; }
+		int peek() { return ( pos < data.size() ) ? (uint8_t)data[ pos ] : -1; }
+
+		std::string data;
+		size_t pos;
+};
+
+static int failures = 0;
+
+static void Expect( bool ok, const char *what, int a = 0, int b = 0 )
+{
+	if ( !ok && failures++ < 20 )
+		printf( "FAIL %s ( %d, %d )\n", what, a, b );
+}
+
+// Brightness of the last frame the display sent
+static int LastBrightness( MemoryStream &log )
+{
+	MemoryStream in( log.data );
+	X7SegmentReplay replay( in );
+
+	if ( !replay.Begin() )
+		return -1;
+
+	while ( replay.ReadFrame() )
+		;
+
+	return replay.GetBrightness();
+}
+
+// Move the clock on, let the fade step, and check the level is where the duration says, give or take one
+static void Step( X7Segment &disp, MemoryStream &log, uint32_t ms, int expected, const char *what )
+{
+	AdvanceClock( ms );
+	disp.Tick();
+
+	int level = LastBrightness( log );
+	Expect( abs( level - expected ) <= 1, what, level, expected );
+}
+
+int main()
+{
+	// A two minute fade out would wrap to under a minute in 16 bits
+	{
+		MemoryStream log;
+		X7SegmentCapture capture( log );
+		X7Segment disp( 5, 10 );
+		disp.Begin(200);
+		disp.SetCapture( &capture );
+		disp.DisplayTextColor( "12345", X7Segment::Color( 255, 0, 0 ) );
+
+		disp.FadeTo( 0, 120000 );
+		Step( disp, log, 30000, 150, "FadeTo a quarter of the way" );
+		Step( disp, log, 30000, 100, "FadeTo half way" );
+		Expect( disp.IsFading(), "FadeTo still running at a minute" );
+		Step( disp, log, 30000, 50, "FadeTo three quarters of the way" );
+		Step( disp, log, 30000, 0, "FadeTo finished" );
+		Expect( !disp.IsFading(), "FadeTo stopped" );
+	}
+
+	// Fade out over the first half, swap the text, fade back in over the second
+	{
+		MemoryStream log;
+		X7SegmentCapture capture( log );
+		X7Segment disp( 5, 10 );
+		disp.Begin(200);
+		disp.SetCapture( &capture );
+		disp.DisplayTextColor( "12345", X7Segment::Color( 255, 0, 0 ) );
+
+		disp.FadeText( "5678", X7Segment::Color( 0, 255, 0 ), 150000 );
+		Step( disp, log, 37500, 100, "FadeText half way out" );
+		Step( disp, log, 37500 + 15000, 40, "FadeText on the way back in" );
+		Step( disp, log, 60000, 200, "FadeText finished" );
+		Expect( !disp.IsFading(), "FadeText stopped" );
+	}
+
+	// A pulse with a period of over three minutes
+	{
+		MemoryStream log;
+		X7SegmentCapture capture( log );
+		X7Segment disp( 5, 10 );
+		disp.Begin(10);
+		disp.SetCapture( &capture );
+		disp.DisplayTextColor( "12345", X7Segment::Color( 255, 0, 0 ) );
+
+		disp.Pulse( 10, 250, 200000 );
+		Step( disp, log, 50000, 130, "Pulse a quarter of the way up" );
+		Step( disp, log, 49000, 248, "Pulse almost at the top" );
+		Step( disp, log, 51000, 130, "Pulse a quarter of the way down" );
+		Step( disp, log, 100000, 130, "Pulse a quarter of the way up again" );
+		Expect( disp.IsFading(), "Pulse keeps running" );
+	}
+
+	// Longer than the multiply can take without scaling - a day
+	{
+		MemoryStream log;
+		X7SegmentCapture capture( log );
+		X7Segment disp( 5, 10 );
+		disp.Begin(255);
+		disp.SetCapture( &capture );
+		disp.DisplayTextColor( "12345", X7Segment::Color( 255, 0, 0 ) );
+
+		disp.FadeTo( 0, 86400000UL );
+		Step( disp, log, 21600000UL, 191, "day long FadeTo a quarter of the way" );
+		Step( disp, log, 21600000UL, 127, "day long FadeTo half way" );
+		Step( disp, log, 43200000UL, 0, "day long FadeTo finished" );
+	}
+
+	printf( "%d failures\n", failures );
+	return failures;
+}
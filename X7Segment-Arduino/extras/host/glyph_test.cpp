@@ -0,0 +1,78 @@
+// ---------------------------------------------------------------------------
+// Created by Seon Rozenblum - seon@unexpectedmaker.com
+// Copyright 2019 License: MIT https://github.com/UnexpectedMaker/X7Segment/LICENSE
+//
+// PURPOSE:
+// Checks DefineGlyph(). New glyphs draw in both cases and outside ASCII,
+// redefining one replaces it, '.' is refused as it is always the decimal
+// point, and the table stops at X7SEGMENT_MAX_GLYPHS.
+//
+// SYNTAX:
+//   glyph_test    - Exit code is the number of failures
+// ---------------------------------------------------------------------------
+
+#include <X7Segment.h>
+
+#include <stdio.h>
+
+static int failures = 0;
+
+static void Expect( bool ok, const char *what, int a = 0, int b = 0 )
+{
+	if ( !ok && failures++ < 20 )
+		printf( "FAIL %s ( %d, %d )\n", what, a, b );
+}
+
+// CRC of a text as drawn, so two texts can be checked for drawing the same segments
+static uint32_t Draw( X7Segment &disp, String text )
+{
+	disp.DisplayTextColor( text, X7Segment::Color( 255, 255, 255 ) );
+	return disp.GetFrameCRC();
+}
+
+int main()
+{
+	X7Segment disp( 2, 10 );
+	disp.Begin(20);
+
+	uint8_t builtIn = disp.GetArraySize();
+
+	// New glyph, looked up in either case
+	Expect( X7Segment::DefineGlyph( 'T', 0b01111000 ), "define t" );
+	Expect( Draw( disp, "t" ) == Draw( disp, "T" ) && Draw( disp, "t" ) != Draw( disp, " " ), "t drawn in both cases" );
+	Expect( disp.GetArraySize() == builtIn + 1 && disp.GetCharacterAtArrayIndex( builtIn ) == "t", "t added to the list" );
+
+	// Redefining takes no new slot, and changes what is drawn
+	Expect( X7Segment::DefineGlyph( 't', 0b01111111 ), "redefine t" );
+	Expect( Draw( disp, "t" ) == Draw( disp, "8" ), "t redrawn" );
+	Expect( disp.GetArraySize() == builtIn + 1, "redefine keeps the count" );
+
+	// A separate shape for ForceUppercase( true )
+	Expect( X7Segment::DefineGlyph( 'k', 0b00000001, 0b01111111 ), "define k" );
+	disp.ForceUppercase( true );
+	Expect( Draw( disp, "k" ) == Draw( disp, "8" ), "upper shape used when forced" );
+	disp.ForceUppercase( false );
+	Expect( Draw( disp, "k" ) != Draw( disp, "8" ), "lower shape used otherwise" );
+
+	// Outside ASCII, like a Latin-1 degree sign
+	Expect( X7Segment::DefineGlyph( (char)0xB0, 0b01111111 ), "define degree sign" );
+	Expect( Draw( disp, String( (char)0xB0 ) ) == Draw( disp, "8" ), "degree sign drawn" );
+
+	// '.' is always the decimal point, so defining it is refused and changes nothing
+	uint32_t before = Draw( disp, "8.8" );
+	Expect( !X7Segment::DefineGlyph( '.', 0b00000001 ), "define '.' refused" );
+	Expect( Draw( disp, "8.8" ) == before, "decimal point unchanged" );
+
+	// Fill the rest of the table, then one more is refused, but redefining still works
+	uint8_t c = 0xC0;
+	while ( disp.GetArraySize() < X7SEGMENT_MAX_GLYPHS )
+		Expect( X7Segment::DefineGlyph( (char)c++, 0b00000001 ), "define to fill the table", c );
+
+	Expect( !X7Segment::DefineGlyph( (char)c, 0b00000001 ), "define past the limit refused", c );
+	Expect( Draw( disp, String( (char)c ) ) == Draw( disp, String( (char)0x01 ) ), "refused glyph stays undefined" );
+	Expect( X7Segment::DefineGlyph( 't', 0b01000000 ), "redefine when full" );
+	Expect( Draw( disp, "t" ) == Draw( disp, "-" ), "redefined when full" );
+
+	printf( "%d failures\n", failures );
+	return failures;
+}
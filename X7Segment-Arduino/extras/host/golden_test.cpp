@@ -0,0 +1,161 @@
+// ---------------------------------------------------------------------------
+// Created by Seon Rozenblum - seon@unexpectedmaker.com
+// Copyright 2019 License: MIT https://github.com/UnexpectedMaker/X7Segment/LICENSE
+//
+// PURPOSE:
+// Host golden image suite. Draws every case from the X7Segment_Golden example
+// on a fresh display, and compares RenderASCII() and RenderPPM() against the
+// files in golden/, and the frame CRC against the example's golden table.
+//
+// SYNTAX:
+//   golden_test <golden dir>            - Check every case, exit code is the number of failures
+//   golden_test <golden dir> --update   - Rewrite the golden files after an intended output change,
+//                                         and print the CRC tables to paste into the example
+// ---------------------------------------------------------------------------
+
+#include "../../examples/X7Segment_Golden/X7Segment_Golden.ino"
+
+#include <string>
+#include <fstream>
+#include <sstream>
+
+class StringPrint : public Print
+{
+	public:
+		std::string data;
+		size_t write( uint8_t b ) { data += (char)b; return 1; }
+};
+
+static std::string goldenDir;
+static bool update = false;
+static int hostFailures = 0;
+
+static bool ReadFile( const std::string &path, std::string &data )
+{
+	std::ifstream in( path.c_str(), std::ios::binary );
+	if ( !in )
+		return false;
+
+	std::stringstream ss;
+	ss << in.rdbuf();
+	data = ss.str();
+	return true;
+}
+
+static void CheckFile( const std::string &name, const std::string &data )
+{
+	std::string path = goldenDir + "/" + name;
+
+	if ( update )
+	{
+		std::ofstream out( path.c_str(), std::ios::binary );
+		out << data;
+		return;
+	}
+
+	std::string golden;
+	if ( !ReadFile( path, golden ) )
+	{
+		printf( "FAIL %s is missing, run with --update to create it\n", name.c_str() );
+		hostFailures++;
+	}
+	else if ( golden != data )
+	{
+		printf( "FAIL %s differs from the golden image\n", name.c_str() );
+		hostFailures++;
+	}
+}
+
+static void CheckCRC( const char *name, uint32_t crc, uint32_t golden )
+{
+	if ( !update && crc != golden )
+	{
+		printf( "FAIL %s CRC 0x%08X, example expects 0x%08X\n", name, (unsigned)crc, (unsigned)golden );
+		hostFailures++;
+	}
+}
+
+static void PrintTable( const uint32_t *crcs, int count, const char *indent )
+{
+	for ( int i = 0; i < count; i++ )
+		printf( "%s0x%08X%s", ( i % 8 == 0 ) ? indent : "", (unsigned)crcs[i], ( i == count - 1 ) ? "\n" : ( i % 8 == 7 ) ? ",\n" : ", " );
+}
+
+int main( int argc, char **argv )
+{
+	if ( argc < 2 )
+	{
+		printf( "usage: golden_test <golden dir> [--update]\n" );
+		return 1;
+	}
+
+	goldenDir = argv[1];
+	update = ( argc > 2 && std::string( argv[2] ) == "--update" );
+
+	uint32_t modeCRCs[ NUM_MODE_CASES ];
+	uint32_t glyphCRCs[ 2 ][ NUM_GLYPH_CASES ] = { { 0 } };
+
+	for ( int i = 0; i < NUM_MODE_CASES; i++ )
+	{
+		X7Segment disp( NUM_BOARDS, DATA_PIN );
+		disp.Begin(20);
+		RenderModeCase( disp, i );
+
+		char name[32];
+		StringPrint ascii, ppm;
+		disp.RenderASCII( ascii );
+		disp.RenderPPM( ppm, 1 );
+
+		snprintf( name, sizeof(name), "mode_%02d.txt", i );
+		CheckFile( name, ascii.data );
+		snprintf( name, sizeof(name), "mode_%02d.ppm", i );
+		CheckFile( name, ppm.data );
+
+		snprintf( name, sizeof(name), "mode %d", i );
+		modeCRCs[i] = disp.GetFrameCRC();
+		CheckCRC( name, modeCRCs[i], goldenModes[i] );
+	}
+
+	// One ASCII file per glyph set, each glyph headed by the character it is
+	for ( int upper = 0; upper < 2; upper++ )
+	{
+		StringPrint ascii;
+
+		for ( int i = 0; i < NUM_GLYPH_CASES; i++ )
+		{
+			X7Segment disp( NUM_BOARDS, DATA_PIN );
+			disp.Begin(20);
+
+			if ( i >= disp.GetArraySize() )
+				break;
+
+			RenderGlyphCase( disp, upper == 1, i );
+
+			ascii.print( "'" );
+			ascii.print( disp.GetCharacterAtArrayIndex(i) );
+			ascii.println( "'" );
+			disp.RenderASCII( ascii );
+
+			char name[32];
+			snprintf( name, sizeof(name), "%s '%s'", upper ? "upper" : "glyph", disp.GetCharacterAtArrayIndex(i).c_str() );
+			glyphCRCs[ upper ][i] = disp.GetFrameCRC();
+			CheckCRC( name, glyphCRCs[ upper ][i], goldenGlyphs[ upper ][i] );
+		}
+
+		CheckFile( upper ? "glyphs_upper.txt" : "glyphs.txt", ascii.data );
+	}
+
+	if ( update )
+	{
+		printf( "Golden files written to %s, CRC tables for X7Segment_Golden.ino:\n\n", goldenDir.c_str() );
+		PrintTable( modeCRCs, NUM_MODE_CASES, "  " );
+		printf( "\n" );
+		PrintTable( glyphCRCs[0], NUM_GLYPH_CASES, "    " );
+		printf( "\n" );
+		PrintTable( glyphCRCs[1], NUM_GLYPH_CASES, "    " );
+		return 0;
+	}
+
+	printf( "%d failures\n", hostFailures );
+	return hostFailures;
+}
@@ -0,0 +1,243 @@
+// ---------------------------------------------------------------------------
+// Created by Seon Rozenblum - seon@unexpectedmaker.com
+// Copyright 2019 License: MIT https://github.com/UnexpectedMaker/X7Segment/LICENSE
+//
+// PURPOSE:
+// Checks X7SegmentScheduler's decisions against made up channel and block
+// pools. Every window must fit the pool, every waiting display must be sent
+// within a few windows, and a removed or destroyed display must be forgotten.
+// Built a second time with ESP32 defined, against the simulated RMT driver in
+// shim/esp32, so channels are really handed out and taken back.
+//
+// SYNTAX:
+//   scheduler_test    - Exit code is the number of failures
+// ---------------------------------------------------------------------------
+
+#include <X7SegmentScheduler.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static int failures = 0;
+
+static void Expect( bool ok, const char *what, int a = 0, int b = 0 )
+{
+	if ( !ok && failures++ < 20 )
+		printf( "FAIL %s ( %d, %d )\n", what, a, b );
+}
+
+// Queue a frame on every display, as a sketch's loop() would
+static void DrawAll( X7Segment **displays, uint8_t count )
+{
+	for ( uint8_t i = 0; i < count; i++ )
+		displays[i]->DisplayTextColor( "88888", X7Segment::Color( 0, 0, 255 ) );
+}
+
+// Let the last window finish, so the next Tick() is allowed to send
+static void WaitForWindow( X7Segment **displays, uint8_t count )
+{
+	uint32_t longest = 0;
+	for ( uint8_t i = 0; i < count; i++ )
+		longest = max( longest, displays[i]->GetFrameMicros() );
+
+	delayMicroseconds( longest + 1 );
+}
+
+static void CheckPool( uint8_t channels, uint8_t blocks, uint8_t count, const uint8_t *boards )
+{
+	X7SegmentScheduler scheduler( channels, blocks );
+	X7Segment *displays[ X7SEGMENT_SCHEDULER_MAX_DISPLAYS ];
+
+	for ( uint8_t i = 0; i < count; i++ )
+	{
+		displays[i] = new X7Segment( boards[i], i );
+		Expect( scheduler.Add( *displays[i] ), "add", i );
+		displays[i]->Begin(20);
+	}
+
+	// Windows since each display was last sent, with every display drawing every window
+	uint8_t waited[ X7SEGMENT_SCHEDULER_MAX_DISPLAYS ] = { 0 };
+
+	for ( int window = 0; window < count * 2 + 4; window++ )
+	{
+		DrawAll( displays, count );
+		WaitForWindow( displays, count );
+
+		uint8_t sending = scheduler.Plan();
+		uint8_t first[ X7SEGMENT_SCHEDULER_MAX_DISPLAYS ];
+		uint8_t used = 0;
+		uint8_t channelsUsed = 0;
+
+		for ( uint8_t i = 0; i < count; i++ )
+		{
+			first[i] = scheduler.GetPlannedBlocks(i);
+			used += first[i];
+			channelsUsed += ( first[i] > 0 );
+
+			Expect( first[i] == 0 || first[i] <= X7SegmentScheduler::BlocksForChain( displays[i]->GetLedCount() ), "no more blocks than the chain needs", window, i );
+		}
+
+		Expect( sending > 0 && sending == channelsUsed, "planned count", window, sending );
+		Expect( used <= blocks, "blocks fit the pool", window, used );
+		Expect( channelsUsed <= channels, "channels fit the pool", window, channelsUsed );
+
+		// Planning again, with nothing sent in between, must give the same answer
+		scheduler.Plan();
+		for ( uint8_t i = 0; i < count; i++ )
+			Expect( scheduler.GetPlannedBlocks(i) == first[i], "Plan() doesn't change whose turn it is", window, i );
+
+		scheduler.Tick();
+
+		// Everything planned has been sent, so planning now only finds the ones left waiting
+		scheduler.Plan();
+		for ( uint8_t i = 0; i < count; i++ )
+		{
+			if ( first[i] > 0 )
+			{
+				Expect( scheduler.GetPlannedBlocks(i) == 0, "sent display is no longer waiting", window, i );
+				waited[i] = 0;
+			}
+			else if ( ++waited[i] >= count )
+			{
+				Expect( false, "display starved", window, i );
+			}
+		}
+	}
+
+	// Removing one closes the gap, and the rest still get sent
+	X7Segment *removed = displays[0];
+	Expect( scheduler.Remove( *removed ), "remove" );
+	Expect( !scheduler.Remove( *removed ), "remove twice" );
+	Expect( scheduler.GetDisplayCount() == count - 1, "count after remove" );
+	delete removed;
+
+	// Destroying one takes it off the scheduler by itself
+	if ( count > 2 )
+	{
+		delete displays[1];
+		Expect( scheduler.GetDisplayCount() == count - 2, "count after destroy" );
+
+		for ( uint8_t i = 2; i < count; i++ )
+			displays[ i - 2 ] = displays[i];
+		count -= 2;
+	}
+	else
+	{
+		displays[0] = displays[1];
+		count -= 1;
+	}
+
+	for ( int window = 0; window < count + 2; window++ )
+	{
+		DrawAll( displays, count );
+		WaitForWindow( displays, count );
+		scheduler.Tick();
+	}
+
+	for ( uint8_t i = 0; i < count; i++ )
+		delete displays[i];
+
+	Expect( scheduler.GetDisplayCount() == 0, "count after every display is destroyed" );
+	scheduler.Tick();
+
+#if defined(ESP32)
+	Expect( rmtChannelsInUse() == 0 && rmtBlocksInUse() == 0, "every channel handed back", rmtChannelsInUse(), rmtBlocksInUse() );
+#endif
+}
+
+// A display added while another is running shrinks the first one's share, which must not lock the new one out
+static void CheckAddWhileRunning()
+{
+	X7SegmentScheduler scheduler;
+	X7Segment *displays[2];
+
+	displays[0] = new X7Segment( 8, 0 );
+	scheduler.Add( *displays[0] );
+	displays[0]->Begin(20);
+
+	for ( int window = 0; window < 3; window++ )
+	{
+		DrawAll( displays, 1 );
+		WaitForWindow( displays, 1 );
+		scheduler.Tick();
+	}
+
+	displays[1] = new X7Segment( 8, 1 );
+	scheduler.Add( *displays[1] );
+	displays[1]->Begin(20);
+
+	uint8_t waited[2] = { 0, 0 };
+
+	for ( int window = 0; window < 8; window++ )
+	{
+		DrawAll( displays, 2 );
+		WaitForWindow( displays, 2 );
+
+		scheduler.Plan();
+		bool planned[2] = { scheduler.GetPlannedBlocks(0) > 0, scheduler.GetPlannedBlocks(1) > 0 };
+
+		scheduler.Tick();
+		scheduler.Plan();
+
+		for ( uint8_t i = 0; i < 2; i++ )
+		{
+			// Still waiting after its turn means it couldn't get a channel
+			if ( planned[i] && scheduler.GetPlannedBlocks(i) == 0 )
+				waited[i] = 0;
+			else if ( ++waited[i] > 2 )
+				Expect( false, "display added while running starved", window, i );
+		}
+
+#if defined(ESP32)
+		Expect( rmtBlocksInUse() <= RMT_SIM_BLOCKS, "blocks fit the RMT", window, rmtBlocksInUse() );
+#endif
+	}
+
+	delete displays[0];
+	delete displays[1];
+
+#if defined(ESP32)
+	Expect( rmtChannelsInUse() == 0 && rmtBlocksInUse() == 0, "every channel handed back after adding while running", rmtChannelsInUse(), rmtBlocksInUse() );
+#endif
+}
+
+int main()
+{
+	const uint8_t same[] = { 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5 };
+	const uint8_t mixed[] = { 1, 8, 2, 5, 1, 1, 3, 12, 1, 2, 4, 1, 6, 1, 2, 1 };
+
+	// The ESP32's pool, then tighter ones than there are displays
+	CheckPool( 8, 8, 12, same );
+	CheckPool( 8, 8, 16, mixed );
+	CheckPool( 3, 8, 7, mixed );
+	CheckPool( 4, 2, 5, same );
+	CheckPool( 1, 1, 4, mixed );
+	CheckPool( 2, 6, 2, mixed );
+
+	// Random pools and chain lengths
+	srand( 1234 );
+	for ( int round = 0; round < 20; round++ )
+	{
+		uint8_t boards[ X7SEGMENT_SCHEDULER_MAX_DISPLAYS ];
+		for ( uint8_t i = 0; i < X7SEGMENT_SCHEDULER_MAX_DISPLAYS; i++ )
+			boards[i] = rand() % 8 + 1;
+
+		CheckPool( rand() % 8 + 1, rand() % 8 + 1, rand() % ( X7SEGMENT_SCHEDULER_MAX_DISPLAYS - 1 ) + 2, boards );
+	}
+
+	CheckAddWhileRunning();
+
+	// A scheduler that goes first mustn't leave its displays pointing at it
+	{
+		X7Segment outlives( 5, 0 );
+		{
+			X7SegmentScheduler scheduler;
+			scheduler.Add( outlives );
+		}
+		outlives.Begin(20);
+		outlives.DisplayTextColor( "12345", X7Segment::Color( 255, 0, 0 ) );
+	}
+
+	printf( "%d failures\n", failures );
+	return failures;
+}
@@ -0,0 +1,42 @@
+// ---------------------------------------------------------------------------
+// Created by Seon Rozenblum - seon@unexpectedmaker.com
+// Copyright 2019 License: MIT https://github.com/UnexpectedMaker/X7Segment/LICENSE
+//
+// PURPOSE:
+// Simulated NeoPixel backend for the host build. Pixels are kept in memory and
+// show() only counts frames, so tests can look at exactly what would be sent.
+// ---------------------------------------------------------------------------
+
+#ifndef Adafruit_NeoPixel_h
+	#define Adafruit_NeoPixel_h
+
+	#include <Arduino.h>
+
+	#define NEO_GRB		0x52
+	#define NEO_KHZ800	0x0000
+
+class Adafruit_NeoPixel
+{
+	public:
+		Adafruit_NeoPixel() : numLEDs( 0 ), pixels( NULL ), brightness( 0 ), shows( 0 ) {}
+		~Adafruit_NeoPixel() { free( pixels ); }
+
+		Adafruit_NeoPixel &operator=( const Adafruit_NeoPixel & ) { return *this; }
+
+		void begin() {}
+		void updateType( uint16_t ) {}
+		void updateLength( uint16_t n ) { free( pixels ); numLEDs = n; pixels = (uint32_t *) calloc( n, sizeof(uint32_t) ); }
+		void setPin( uint8_t ) {}
+		void setBrightness( uint8_t b ) { brightness = b; }
+		uint8_t getBrightness() { return brightness; }
+		void setPixelColor( uint16_t n, uint32_t c ) { if ( n < numLEDs ) pixels[n] = c; }
+		uint32_t getPixelColor( uint16_t n ) { return ( n < numLEDs ) ? pixels[n] : 0; }
+		void show() { shows++; }
+
+		uint16_t numLEDs;
+		uint32_t *pixels;
+		uint8_t brightness;
+		uint32_t shows;
+};
+
+#endif
@@ -0,0 +1,41 @@
+// ---------------------------------------------------------------------------
+// Created by Seon Rozenblum - seon@unexpectedmaker.com
+// Copyright 2019 License: MIT https://github.com/UnexpectedMaker/X7Segment/LICENSE
+//
+// See "Arduino.h" for purpose.
+// ---------------------------------------------------------------------------
+
+#include "Arduino.h"
+#include <chrono>
+#include <thread>
+
+HostSerial Serial;
+
+static const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+static unsigned long skippedMicros = 0;
+
+unsigned long millis()
+{
+	return micros() / 1000;
+}
+
+unsigned long micros()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>( std::chrono::steady_clock::now() - startTime ).count() + skippedMicros;
+}
+
+void AdvanceClock( unsigned long ms )
+{
+	skippedMicros += ms * 1000;
+}
+
+void delay( unsigned long ms )
+{
+	std::this_thread::sleep_for( std::chrono::milliseconds( ms ) );
+}
+
+void delayMicroseconds( unsigned int us )
+{
+	std::this_thread::sleep_for( std::chrono::microseconds( us ) );
+}
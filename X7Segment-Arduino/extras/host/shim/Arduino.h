@@ -0,0 +1,115 @@
+// ---------------------------------------------------------------------------
+// Created by Seon Rozenblum - seon@unexpectedmaker.com
+// Copyright 2019 License: MIT https://github.com/UnexpectedMaker/X7Segment/LICENSE
+//
+// PURPOSE:
+// Just enough of the Arduino core for the library and its examples to build
+// and run on a desktop machine, for the host tests and benchmark. Serial goes
+// to stdout, and millis() / micros() are the host's monotonic clock, which
+// tests can move forward with AdvanceClock().
+// ---------------------------------------------------------------------------
+
+#ifndef Arduino_h
+	#define Arduino_h
+
+	#include <stdint.h>
+	#include <stddef.h>
+	#include <stdlib.h>
+	#include <string.h>
+	#include <stdio.h>
+	#include <stdarg.h>
+	#include <ctype.h>
+	#include <math.h>
+	#include <algorithm>
+	#include <string>
+
+	#define PROGMEM
+	#define pgm_read_byte(p) ( *(const uint8_t *)(p) )
+	#define pgm_read_word(p) ( *(const uint16_t *)(p) )
+	#define pgm_read_dword(p) ( *(const uint32_t *)(p) )
+
+	#define bitRead(value, bit) ( ( (value) >> (bit) ) & 0x01 )
+
+	#define DEC 10
+	#define HEX 16
+
+	typedef uint8_t byte;
+	using std::min;
+	using std::max;
+
+	unsigned long millis();
+	unsigned long micros();
+	void delay( unsigned long ms );
+	void delayMicroseconds( unsigned int us );
+
+	// Host only - move millis() and micros() on without waiting, for tests of long running fades
+	void AdvanceClock( unsigned long ms );
+
+class String
+{
+	public:
+		String( const char *s = "" ) : str( s ) {}
+		explicit String( char c ) : str( 1, c ) {}
+		String( int v ) : str( std::to_string( v ) ) {}
+		String( unsigned int v ) : str( std::to_string( v ) ) {}
+		String( long v ) : str( std::to_string( v ) ) {}
+		String( unsigned long v ) : str( std::to_string( v ) ) {}
+
+		unsigned int length() const { return str.size(); }
+		char charAt( unsigned int i ) const { return ( i < str.size() ) ? str[i] : 0; }
+		const char *c_str() const { return str.c_str(); }
+
+		bool operator==( const String &o ) const { return str == o.str; }
+		bool operator!=( const String &o ) const { return str != o.str; }
+		String &operator+=( const String &o ) { str += o.str; return *this; }
+		String &operator+=( char c ) { str += c; return *this; }
+		friend String operator+( const String &a, const String &b ) { String r( a ); return r += b; }
+
+	private:
+		std::string str;
+};
+
+class Print
+{
+	public:
+		virtual ~Print() {}
+		virtual size_t write( uint8_t b ) = 0;
+
+		size_t print( const char *s ) { size_t n = 0; while ( *s ) n += write( *s++ ); return n; }
+		size_t print( const String &s ) { return print( s.c_str() ); }
+		size_t print( char c ) { return write( c ); }
+		size_t print( unsigned long v, int base = DEC ) { char b[24]; snprintf( b, 24, ( base == HEX ) ? "%lX" : "%lu", v ); return print( b ); }
+		size_t print( long v, int base = DEC ) { return ( v < 0 && base == DEC ) ? print( '-' ) + print( (unsigned long)-v ) : print( (unsigned long)v, base ); }
+		size_t print( unsigned int v, int base = DEC ) { return print( (unsigned long)v, base ); }
+		size_t print( int v, int base = DEC ) { return print( (long)v, base ); }
+		size_t print( unsigned char v, int base = DEC ) { return print( (unsigned long)v, base ); }
+		size_t print( double v, int digits = 2 ) { char b[32]; snprintf( b, 32, "%.*f", digits, v ); return print( b ); }
+
+		size_t printf( const char *format, ... ) { char b[256]; va_list args; va_start( args, format ); vsnprintf( b, sizeof(b), format, args ); va_end( args ); return print( b ); }
+
+		size_t println() { return print( "\r\n" ); }
+		template <typename T> size_t println( T v ) { size_t n = print( v ); return n + println(); }
+		template <typename T> size_t println( T v, int format ) { size_t n = print( v, format ); return n + println(); }
+};
+
+class Stream : public Print
+{
+	public:
+		virtual int available() = 0;
+		virtual int read() = 0;
+		virtual int peek() = 0;
+};
+
+class HostSerial : public Stream
+{
+	public:
+		void begin( unsigned long ) {}
+		size_t write( uint8_t b ) { return fputc( b, stdout ) == EOF ? 0 : 1; }
+		int available() { return 0; }
+		int read() { return -1; }
+		int peek() { return -1; }
+};
+
+extern HostSerial Serial;
+
+#endif
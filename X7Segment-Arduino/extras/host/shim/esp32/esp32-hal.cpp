@@ -0,0 +1,78 @@
+// ---------------------------------------------------------------------------
+// Created by Seon Rozenblum - seon@unexpectedmaker.com
+// Copyright 2019 License: MIT https://github.com/UnexpectedMaker/X7Segment/LICENSE
+//
+// See "esp32-hal.h" for purpose and syntax.
+// ---------------------------------------------------------------------------
+
+#include "esp32-hal.h"
+
+struct rmt_obj_s
+{
+	int pin;
+	uint8_t blocks;
+};
+
+static uint8_t channelsInUse = 0;
+static uint8_t blocksInUse = 0;
+static uint32_t writeCount = 0;
+
+rmt_obj_t *rmtInit( int pin, bool tx_not_rx, rmt_reserve_memsize_t memsize )
+{
+	(void)tx_not_rx;
+
+	if ( channelsInUse >= RMT_SIM_CHANNELS || blocksInUse + memsize > RMT_SIM_BLOCKS )
+		return NULL;
+
+	channelsInUse++;
+	blocksInUse += memsize;
+
+	rmt_obj_t *rmt = new rmt_obj_t;
+	rmt->pin = pin;
+	rmt->blocks = memsize;
+	return rmt;
+}
+
+float rmtSetTick( rmt_obj_t *rmt, float tick )
+{
+	(void)rmt;
+	return tick;
+}
+
+bool rmtWrite( rmt_obj_t *rmt, rmt_data_t *data, size_t size )
+{
+	(void)data;
+	(void)size;
+
+	if ( rmt == NULL )
+		return false;
+
+	writeCount++;
+	return true;
+}
+
+bool rmtDeinit( rmt_obj_t *rmt )
+{
+	if ( rmt == NULL )
+		return false;
+
+	channelsInUse--;
+	blocksInUse -= rmt->blocks;
+	delete rmt;
+	return true;
+}
+
+uint8_t rmtChannelsInUse()
+{
+	return channelsInUse;
+}
+
+uint8_t rmtBlocksInUse()
+{
+	return blocksInUse;
+}
+
+uint32_t rmtWriteCount()
+{
+	return writeCount;
+}
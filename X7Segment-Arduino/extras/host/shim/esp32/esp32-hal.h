@@ -0,0 +1,55 @@
+// ---------------------------------------------------------------------------
+// Created by Seon Rozenblum - seon@unexpectedmaker.com
+// Copyright 2019 License: MIT https://github.com/UnexpectedMaker/X7Segment/LICENSE
+//
+// PURPOSE:
+// Simulated RMT driver for the host build with ESP32 defined. Like the real
+// one, it has 8 channels sharing 8 blocks of memory, and rmtInit() fails when
+// either runs out, so the scheduler can be tested against the real limits.
+//
+// SYNTAX:
+//   rmtChannelsInUse()    - Channels handed out and not yet freed with rmtDeinit()
+//   rmtBlocksInUse()      - Memory blocks held by those channels
+//   rmtWriteCount()       - Number of rmtWrite() calls, one per frame sent
+// ---------------------------------------------------------------------------
+
+#ifndef esp32_hal_h
+	#define esp32_hal_h
+
+	#include <Arduino.h>
+
+	#define RMT_SIM_CHANNELS	8
+	#define RMT_SIM_BLOCKS		8
+
+typedef struct
+{
+	uint32_t duration0 : 15;
+	uint32_t level0 : 1;
+	uint32_t duration1 : 15;
+	uint32_t level1 : 1;
+} rmt_data_t;
+
+typedef struct rmt_obj_s rmt_obj_t;
+
+typedef enum
+{
+	RMT_MEM_64 = 1,
+	RMT_MEM_128 = 2,
+	RMT_MEM_192 = 3,
+	RMT_MEM_256 = 4,
+	RMT_MEM_320 = 5,
+	RMT_MEM_384 = 6,
+	RMT_MEM_448 = 7,
+	RMT_MEM_512 = 8
+} rmt_reserve_memsize_t;
+
+rmt_obj_t *rmtInit( int pin, bool tx_not_rx, rmt_reserve_memsize_t memsize );
+float rmtSetTick( rmt_obj_t *rmt, float tick );
+bool rmtWrite( rmt_obj_t *rmt, rmt_data_t *data, size_t size );
+bool rmtDeinit( rmt_obj_t *rmt );
+
+uint8_t rmtChannelsInUse();
+uint8_t rmtBlocksInUse();
+uint32_t rmtWriteCount();
+
+#endif
@@ -0,0 +1 @@
+// Nothing from FreeRTOS is used by the library, the header only has to exist for the host build
@@ -0,0 +1,304 @@
+// ---------------------------------------------------------------------------
+// Created by Seon Rozenblum - seon@unexpectedmaker.com
+// Copyright 2019 License: MIT https://github.com/UnexpectedMaker/X7Segment/LICENSE
+//
+// PURPOSE:
+// Drives X7SegmentStream from a plain byte source, with a pipe standing in
+// for the serial link. Built from X7SegmentStream.cpp alone, without the
+// Arduino shim, to show the parser has no other dependencies.
+//
+// SYNTAX:
+//   stream_pipe generate <packets> [digits] [noise%] - Write random packets to stdout, with noise bytes between some
+//   stream_pipe [digits]                             - Parse stdin, and print packet, error and throughput counts
+//   stream_pipe selftest                             - Check decoding against known packets fed in random sized
+//                                                      chunks, then fuzz the parser with random bytes
+//
+//   stream_pipe generate 100000 64 | stream_pipe 64
+// ---------------------------------------------------------------------------
+
+#include "X7SegmentStream.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+
+class RecordingSink : public X7SegmentSink
+{
+	public:
+		RecordingSink( uint8_t count ) : digits( count ), segments( count, 0 ), colors( count, 0 ), brightness( 0 ), shows( 0 ) {}
+
+		uint8_t GetDisplayCount() { return digits; }
+		void SetDigit( uint8_t index, uint8_t seg, uint32_t color ) { if ( index < digits ) { segments[ index ] = seg; colors[ index ] = color; } }
+		void SetBrightness( uint8_t b ) { brightness = b; }
+		void Show() { shows++; }
+
+		uint8_t digits;
+		std::vector<uint8_t> segments;
+		std::vector<uint32_t> colors;
+		uint8_t brightness;
+		uint32_t shows;
+};
+
+static std::vector<uint8_t> MakePacket( uint8_t cmd, const std::vector<uint8_t> &payload )
+{
+	std::vector<uint8_t> packet;
+	packet.push_back( X7SEGMENT_STREAM_SYNC );
+	packet.push_back( cmd );
+	packet.push_back( payload.size() & 0xFF );
+	packet.push_back( payload.size() >> 8 );
+	packet.insert( packet.end(), payload.begin(), payload.end() );
+
+	uint8_t crc = 0;
+	for ( size_t i = 1; i < packet.size(); i++ )
+		crc = X7SegmentStream::Crc8( crc, packet[i] );
+
+	packet.push_back( crc );
+	return packet;
+}
+
+// A random full frame, delta frame or brightness packet for a chain of digits
+static std::vector<uint8_t> RandomPacket( uint8_t digits )
+{
+	std::vector<uint8_t> payload;
+	int kind = rand() % 3;
+
+	if ( kind == 0 )
+	{
+		for ( int d = 0; d < digits * 4; d++ )
+			payload.push_back( rand() );
+		return MakePacket( X7SEGMENT_STREAM_FRAME, payload );
+	}
+
+	if ( kind == 1 )
+	{
+		for ( int n = rand() % digits + 1; n > 0; n-- )
+		{
+			payload.push_back( rand() % digits );
+			for ( int b = 0; b < 4; b++ )
+				payload.push_back( rand() );
+		}
+		return MakePacket( X7SEGMENT_STREAM_DELTA, payload );
+	}
+
+	payload.push_back( rand() );
+	return MakePacket( X7SEGMENT_STREAM_BRIGHTNESS, payload );
+}
+
+// Noise bytes never include the sync byte, so every packet that follows is still found
+static void AddNoise( std::vector<uint8_t> &out )
+{
+	for ( int n = rand() % 8 + 1; n > 0; n-- )
+	{
+		uint8_t b = rand();
+		out.push_back( b == X7SEGMENT_STREAM_SYNC ? 0 : b );
+	}
+}
+
+static int Generate( long packets, uint8_t digits, int noise )
+{
+	for ( long i = 0; i < packets; i++ )
+	{
+		std::vector<uint8_t> out;
+		if ( rand() % 100 < noise )
+			AddNoise( out );
+
+		std::vector<uint8_t> packet = RandomPacket( digits );
+		out.insert( out.end(), packet.begin(), packet.end() );
+		fwrite( out.data(), 1, out.size(), stdout );
+	}
+
+	return 0;
+}
+
+static int Parse( uint8_t digits )
+{
+	RecordingSink sink( digits );
+	X7SegmentStream parser( sink );
+
+	uint8_t chunk[ 4096 ];
+	size_t total = 0;
+	size_t got;
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	while ( ( got = fread( chunk, 1, sizeof(chunk), stdin ) ) > 0 )
+	{
+		total += got;
+
+		// Push in as much as fits, applying packets to make room, like Poll() does
+		for ( size_t done = 0; done < got; )
+		{
+			done += parser.Write( chunk + done, got - done );
+			parser.Process();
+		}
+	}
+
+	double seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+
+	printf( "digits %u, buffer %u bytes\n", digits, parser.GetBufferSize() );
+	printf( "%zu bytes, %u packets, %u errors, %u oversize\n", total, parser.GetPacketCount(), parser.GetErrorCount(), parser.GetOversizeCount() );
+	printf( "%.2f MB/s, %.0f packets/s\n", total / seconds / 1e6, parser.GetPacketCount() / seconds );
+
+	return 0;
+}
+
+// What a packet should do to a sink, worked out straight from the packet format
+static void ApplyPacket( RecordingSink &sink, const std::vector<uint8_t> &packet )
+{
+	const uint8_t *p = &packet[4];
+	size_t len = packet.size() - 5;
+
+	switch( packet[1] )
+	{
+		case X7SEGMENT_STREAM_FRAME:
+			for ( uint8_t d = 0; d < sink.digits; d++ )
+				sink.SetDigit( d, ( d * 4u < len ) ? p[ d * 4 ] : 0, ( d * 4u < len ) ? ( (uint32_t)p[ d * 4 + 1 ] << 16 ) | ( p[ d * 4 + 2 ] << 8 ) | p[ d * 4 + 3 ] : 0 );
+			break;
+
+		case X7SEGMENT_STREAM_DELTA:
+			for ( size_t i = 0; i < len; i += 5 )
+				sink.SetDigit( p[i], p[ i + 1 ], ( (uint32_t)p[ i + 2 ] << 16 ) | ( p[ i + 3 ] << 8 ) | p[ i + 4 ] );
+			break;
+
+		case X7SEGMENT_STREAM_BRIGHTNESS:
+			sink.SetBrightness( p[0] );
+			break;
+	}
+
+	sink.Show();
+}
+
+static int failures = 0;
+
+static void Expect( bool ok, const char *what )
+{
+	if ( !ok )
+	{
+		printf( "FAIL %s\n", what );
+		failures++;
+	}
+}
+
+static int SelfTest()
+{
+	srand( 1234 );
+
+	// Known packets, with noise between them, fed in random sized chunks
+	const uint8_t digits = 64;
+	RecordingSink sink( digits );
+	RecordingSink expected( digits );
+	X7SegmentStream parser( sink );
+
+	Expect( parser.GetBufferSize() >= digits * 5 + 5, "buffer holds a delta frame for every digit" );
+
+	std::vector<uint8_t> stream;
+	const int PACKETS = 2000;
+
+	for ( int i = 0; i < PACKETS; i++ )
+	{
+		if ( i % 3 == 0 )
+			AddNoise( stream );
+
+		std::vector<uint8_t> packet = RandomPacket( digits );
+		stream.insert( stream.end(), packet.begin(), packet.end() );
+		ApplyPacket( expected, packet );
+	}
+
+	for ( size_t done = 0; done < stream.size(); )
+	{
+		size_t len = rand() % 300 + 1;
+		done += parser.Write( stream.data() + done, std::min( len, stream.size() - done ) );
+
+		if ( rand() % 4 == 0 )
+			parser.Process();
+	}
+	while ( parser.Process() > 0 )
+		;
+
+	Expect( parser.GetPacketCount() == PACKETS, "every packet decoded" );
+	Expect( sink.shows == PACKETS, "every packet shown" );
+	Expect( sink.segments == expected.segments && sink.colors == expected.colors, "digits match the packets when fed in chunks" );
+	Expect( sink.brightness == expected.brightness, "brightness matches the packets when fed in chunks" );
+
+	// A full frame for all 64 digits must not be lost
+	{
+		RecordingSink big( 64 );
+		X7SegmentStream bigParser( big );
+		std::vector<uint8_t> payload( 64 * 4, 0x7F );
+		std::vector<uint8_t> packet = MakePacket( X7SEGMENT_STREAM_FRAME, payload );
+		bigParser.Write( packet.data(), packet.size() );
+		bigParser.Process();
+		Expect( bigParser.GetPacketCount() == 1 && bigParser.GetErrorCount() == 0 && big.segments[63] == 0x7F, "64 digit full frame" );
+	}
+
+	// A packet too big for the buffer is counted as oversize, and the next packet still gets through
+	{
+		RecordingSink small( 5 );
+		X7SegmentStream smallParser( small );
+		uint8_t huge[] = { X7SEGMENT_STREAM_SYNC, X7SEGMENT_STREAM_FRAME, 0xFF, 0x7F };
+		std::vector<uint8_t> packet = MakePacket( X7SEGMENT_STREAM_BRIGHTNESS, std::vector<uint8_t>( 1, 42 ) );
+		smallParser.Write( huge, sizeof(huge) );
+		smallParser.Write( packet.data(), packet.size() );
+		smallParser.Process();
+		Expect( smallParser.GetOversizeCount() == 1 && small.brightness == 42, "oversize packet skipped" );
+	}
+
+	// Random bytes - must never crash or write outside the sink
+	{
+		RecordingSink fuzz( 8 );
+		X7SegmentStream fuzzParser( fuzz );
+		uint8_t bytes[ 512 ];
+
+		for ( int round = 0; round < 20000; round++ )
+		{
+			size_t len = rand() % sizeof(bytes) + 1;
+			for ( size_t i = 0; i < len; i++ )
+				bytes[i] = ( rand() % 16 == 0 ) ? X7SEGMENT_STREAM_SYNC : rand();
+
+			for ( size_t done = 0; done < len; )
+			{
+				done += fuzzParser.Write( bytes + done, len - done );
+				fuzzParser.Process();
+			}
+		}
+
+		Expect( fuzz.segments.size() == 8, "fuzzing" );
+	}
+
+	printf( "%d failures\n", failures );
+	return failures;
+}
+
+static int Usage()
+{
+	fprintf( stderr, "usage: stream_pipe generate <packets> [digits] [noise%%]\n" );
+	fprintf( stderr, "       stream_pipe [digits]\n" );
+	fprintf( stderr, "       stream_pipe selftest\n" );
+	fprintf( stderr, "digits must be 1 to 255\n" );
+	return 1;
+}
+
+int main( int argc, char **argv )
+{
+	if ( argc > 1 && strcmp( argv[1], "selftest" ) == 0 )
+		return SelfTest();
+
+	bool generate = ( argc > 2 && strcmp( argv[1], "generate" ) == 0 );
+
+	// The chain length is a uint8_t, and a chain of none would divide by zero when picking digits
+	int digits = 5;
+	if ( generate && argc > 3 )
+		digits = atoi( argv[3] );
+	else if ( !generate && argc > 1 )
+		digits = atoi( argv[1] );
+
+	if ( digits < 1 || digits > 255 )
+		return Usage();
+
+	if ( generate )
+		return Generate( atol( argv[2] ), digits, ( argc > 4 ) ? atoi( argv[4] ) : 10 );
+
+	return Parse( digits );
+}
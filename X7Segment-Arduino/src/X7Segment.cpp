@@ -6,6 +6,8 @@
 // ---------------------------------------------------------------------------
 
 #include "X7Segment.h"
+#include "X7SegmentCapture.h"
+#include "X7SegmentScheduler.h"
 
 #if defined(ESP32)
     #include "freertos/FreeRTOS.h"
@@ -17,9 +19,10 @@
     #include <Adafruit_NeoPixel.h>
 #endif
 
-#define DEBUG
-#define NUM_PIXELS_PER_BOARD 15
-#define NUM_PIXELS_PER_SEGMENT 2
+// Define X7SEGMENT_NO_DEBUG in the build to keep Begin() quiet, like the host tests do
+#ifndef X7SEGMENT_NO_DEBUG
+    #define DEBUG
+#endif
 
 // Array of pixels per segment, 7 segments with 4 pixels each
 byte segmentsPixels[8][4] 	{ { 0, 1 }, 
@@ -46,7 +49,7 @@ byte pixelsXY[15][2]		{ 	{ 1,0 }, { 2,0 },
 // Available characters a 7 Segment display can show					  
 const byte ARRAY_SIZE = 32;
 
-byte available_codes[ ARRAY_SIZE ][ 2 ] {
+const byte PROGMEM available_codes[ ARRAY_SIZE ][ 2 ] {
 							{ '0', 0b00111111  }, 
 							{ '1', 0b00000110 },
 							{ '2', 0b01011011 },
@@ -81,7 +84,7 @@ byte available_codes[ ARRAY_SIZE ][ 2 ] {
 							{ ' ', 0b00000000 }
 						};
 
-byte available_codes_upper[ ARRAY_SIZE ][ 2 ] {
+const byte PROGMEM available_codes_upper[ ARRAY_SIZE ][ 2 ] {
 							{ '0', 0b00111111 }, 
 							{ '1', 0b00000110 },
 							{ '2', 0b01011011 },
@@ -116,6 +119,19 @@ byte available_codes_upper[ ARRAY_SIZE ][ 2 ] {
 							{ ' ', 0b00000000 }
 						};					
 
+// Each glyph is stored once, in a slot, and glyphSlot[] finds the slot directly from the character, so
+// lookup cost doesn't grow with the number of glyphs. Slot 0 is for every character without a glyph.
+// They start out with the characters above, and DefineGlyph() can add to or override them at runtime.
+#define GLYPH_TABLE_SIZE 256
+#define GLYPH_UNDEFINED 0xFF
+
+byte glyphSlot[ GLYPH_TABLE_SIZE ];
+byte glyphs[ X7SEGMENT_MAX_GLYPHS + 1 ];
+byte glyphs_upper[ X7SEGMENT_MAX_GLYPHS + 1 ];
+char glyph_chars[ X7SEGMENT_MAX_GLYPHS + 1 ];
+byte glyphCount = 0;
+uint32_t glyphGeneration = 0;
+bool glyphsReady = false;
 
 													
 X7Segment::X7Segment( uint8_t displayCount, uint8_t dPin )
@@ -127,10 +143,26 @@ X7Segment::X7Segment( uint8_t displayCount, uint8_t dPin )
     leds = (uint32_t *) malloc( ledCount * sizeof(uint32_t));
 
     brightness = 90;
+	capture = NULL;
+	scheduler = NULL;
+	framePending = false;
+	frameDeferred = false;
+	governorEnabled = false;
+	frameCallback = NULL;
+	lastFrameMicros = 0;
+	lastReadyMicros = 0;
+	cachedBytes = NULL;
+	cachedLength = 0;
+	cacheValid = false;
+	encodeMicros = 0;
+	transmitMicros = 0;
+	waitMicros = 0;
+	fadeMode = FADE_NONE;
 
 #if defined(ESP32)
 
-
+	led_data = NULL;
+	ApplyBrightness( brightness );
 
 #else
 
@@ -141,6 +173,10 @@ X7Segment::X7Segment( uint8_t displayCount, uint8_t dPin )
 
 #endif
 
+    SetupCharacters();
+	glyphTable = glyphs;
+	cachedGeneration = glyphGeneration;
+
     ClearBuffer();
 	isReady = false;
 }
@@ -148,6 +184,20 @@ X7Segment::X7Segment( uint8_t displayCount, uint8_t dPin )
 X7Segment::~X7Segment()
 {
 	isReady = false;
+
+	// Don't leave the scheduler holding a pointer to us
+	if ( scheduler != NULL )
+		scheduler->Remove( *this );
+
+#if defined(ESP32)
+	if ( rmt_send != NULL )
+		rmtDeinit( rmt_send );
+
+	free( led_data );
+#endif
+
+	free( cachedBytes );
+	free( leds );
 }
 
 bool X7Segment::IsReady()
@@ -165,26 +215,32 @@ void X7Segment::Begin( uint8_t bright )
 
     led_data = (rmt_data_t *) malloc( ( 24 * ledCount ) * sizeof(rmt_data_t) );
 
-     if ((rmt_send = rmtInit(dispPin, true, RMT_MEM_64)) == NULL)
+    // Displays on a scheduler share its RMT channels, so only grab our own when we don't have one
+    if ( scheduler == NULL )
     {
+        if ((rmt_send = rmtInit(dispPin, true, RMT_MEM_64)) == NULL)
+        {
+            // Out of RMT channels - stay not ready, rather than carry on with nothing to send through
+            Serial.printf("X7Segment: no free RMT channel for pin %d, use an X7SegmentScheduler to share channels\n", dispPin);
+            return;
+        }
+
+        float realTick = rmtSetTick(rmt_send, 100);
         #ifdef DEBUG
-            Serial.println("init sender failed\n");
+            Serial.printf("real tick set to: %fns\n", realTick);
         #endif
     }
 
-    float realTick = rmtSetTick(rmt_send, 100);
-    #ifdef DEBUG
-        Serial.printf("real tick set to: %fns\n", realTick);
-    #endif
-
-    brightness = bright;
 #else
 	pixels.begin(); // This initializes the NeoPixel library.
 	pixels.show();
-	pixels.setBrightness( bright );
 #endif
 
+	ApplyBrightness( bright );
+
 	cachedString = "";
+	cachedLength = 0;
+	cacheValid = false;
 	cachedBytes = (byte *) malloc(dispCount * sizeof(byte));
 	
 	for ( int i = 0; i < dispCount; i++ )
@@ -199,33 +255,232 @@ void X7Segment::Begin( uint8_t bright )
 	//Digits are initialised and ready
 	isReady = true;
 	isForcedUpper = false;
+	glyphTable = glyphs;
 }
 
 void X7Segment::SetBrightness( uint8_t bright )
 {
 	if ( isReady )
 	{
-        #if defined(ESP32)
-            brightness = bright;
-        #else
-		    pixels.setBrightness( bright );
-        #endif
+		// Setting the brightness directly wins over any fade that is running
+		fadeMode = FADE_NONE;
+		ApplyBrightness( bright );
+	}
+}
+
+// Brightness is applied on the way out, so changing it never needs the text re-rendered
+void X7Segment::ApplyBrightness( uint8_t bright )
+{
+	brightness = bright;
+
+	#if defined(ESP32)
+		// Integer rounding, which gives the same table as round( i * brightness / 255.0 ) without any float math
+		for ( uint16_t i = 0; i < 256; i++ )
+			brightnessLUT[i] = ( i * bright + 127 ) / 255;
+	#else
+		pixels.setBrightness( bright );
+	#endif
+}
+
+void X7Segment::FadeTo( uint8_t bright, uint32_t duration )
+{
+	if ( !isReady )
+		return;
+
+	fadeMode = FADE_TO;
+	fadeStart = millis();
+	fadeDuration = duration;
+	fadeFrom = brightness;
+	fadeTarget = bright;
+}
+
+void X7Segment::FadeText( String text, uint32_t color, uint32_t duration )
+{
+	if ( !isReady )
+		return;
+
+	// Fade out over the first half, swap the text while it's dark, then fade back in
+	fadeMode = FADE_TEXT;
+	fadeStart = millis();
+	fadeDuration = duration;
+	fadeFrom = brightness;
+	fadeTarget = brightness;
+	fadeText = text;
+	fadeColor = color;
+	fadeSwapped = false;
+}
+
+void X7Segment::Pulse( uint8_t low, uint8_t high, uint32_t period )
+{
+	if ( !isReady )
+		return;
+
+	fadeMode = FADE_PULSE;
+	fadeStart = millis();
+	fadeDuration = max( period, (uint32_t)2 );
+	fadeFrom = low;
+	fadeTarget = high;
+}
+
+void X7Segment::StopFade()
+{
+	fadeMode = FADE_NONE;
+}
+
+bool X7Segment::IsFading()
+{
+	return ( fadeMode != FADE_NONE );
+}
+
+// Call every loop() - steps any fade, sends a frame the governor held back, and lets the
+// frame ready callback draw the next frame once the chain can show it
+void X7Segment::Tick()
+{
+	if ( !isReady )
+		return;
+
+	StepFade();
+
+	uint32_t now = micros();
+
+	if ( now - lastFrameMicros < GetFrameMicros() )
+		return;
+
+	// At most once a frame time, even when the callback doesn't draw anything
+	if ( frameCallback != NULL && now - lastReadyMicros >= GetFrameMicros() )
+	{
+		lastReadyMicros = now;
+		frameCallback( *this );
+	}
+
+	if ( frameDeferred )
+		FillBuffer();
+}
+
+// Steps any fade that is running by re-sending the existing frame
+// Level part way from one brightness to another, elapsed must be less than duration.
+// The multiply has to fit in 32 bits, so fades longer than a couple of hours are scaled down first.
+static int32_t FadeLevel( int32_t from, int32_t to, uint32_t elapsed, uint32_t duration )
+{
+	while ( duration > 0x7FFFFF )
+	{
+		duration >>= 1;
+		elapsed >>= 1;
+	}
+
+	return from + ( ( to - from ) * (int32_t)elapsed ) / (int32_t)duration;
+}
+
+void X7Segment::StepFade()
+{
+	if ( fadeMode == FADE_NONE )
+		return;
+
+	uint32_t elapsed = millis() - fadeStart;
+	int level = brightness;
+
+	switch( fadeMode )
+	{
+		case FADE_TO:
+			if ( elapsed >= fadeDuration )
+			{
+				level = fadeTarget;
+				fadeMode = FADE_NONE;
+			}
+			else
+			{
+				level = FadeLevel( fadeFrom, fadeTarget, elapsed, fadeDuration );
+			}
+			break;
+
+		case FADE_TEXT:
+		{
+			uint32_t half = fadeDuration / 2;
+
+			if ( elapsed < half )
+			{
+				level = FadeLevel( fadeFrom, 0, elapsed, half );
+				break;
+			}
+
+			if ( !fadeSwapped )
+			{
+				// Render the new text once, while the display is dark
+				ApplyBrightness( 0 );
+				DisplayTextColor( fadeText, fadeColor );
+				fadeSwapped = true;
+			}
+
+			if ( elapsed >= fadeDuration )
+			{
+				level = fadeTarget;
+				fadeMode = FADE_NONE;
+			}
+			else
+			{
+				level = FadeLevel( 0, fadeTarget, elapsed - half, fadeDuration - half );
+			}
+			break;
+		}
+
+		case FADE_PULSE:
+		{
+			uint32_t half = fadeDuration / 2;
+			uint32_t phase = elapsed % fadeDuration;
+
+			if ( phase < half )
+				level = FadeLevel( fadeFrom, fadeTarget, phase, half );
+			else
+				level = FadeLevel( fadeTarget, fadeFrom, phase - half, fadeDuration - half );
+			break;
+		}
+
+		case FADE_NONE:
+			break;
+	}
+
+	if ( level != brightness )
+	{
+		ApplyBrightness( level );
+		FillBuffer();
 	}
 }
 
 void X7Segment::ForceUppercase( bool force )
 {
+	if ( force != isForcedUpper )
+		cacheValid = false;
+
 	isForcedUpper = force;
+	glyphTable = ( force ? glyphs_upper : glyphs );
 }
 
 byte X7Segment::GetArraySize()
 {
-	return ARRAY_SIZE;
+	return glyphCount;
 }
 
 String X7Segment::GetCharacterAtArrayIndex( int index )
 {
-	return ( (String)(char)available_codes[ index ][0] );
+	if ( index < 0 || index >= glyphCount )
+		return "";
+
+	return ( (String)glyph_chars[ index + 1 ] );
+}
+
+uint8_t X7Segment::GetDisplayCount()
+{
+	return dispCount;
+}
+
+uint16_t X7Segment::GetLedCount()
+{
+	return ledCount;
+}
+
+void X7Segment::SetCapture( X7SegmentCapture *cap )
+{
+	capture = cap;
 }
 
 void X7Segment::ClearBuffer()
@@ -255,6 +510,141 @@ uint32_t X7Segment::gamma32(uint32_t x) {
   return x; // Packed 32-bit return
 }
 
+// One color channel across the 1530 step hue wheel. Red reads it at the hue, green 1020 steps
+// along and blue 510 steps along, which gives the same hexcone as the old branch ladder.
+static const uint8_t PROGMEM _HueRampTable[1530] = {
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+  254,253,252,251,250,249,248,247,246,245,244,243,242,241,240,239,
+  238,237,236,235,234,233,232,231,230,229,228,227,226,225,224,223,
+  222,221,220,219,218,217,216,215,214,213,212,211,210,209,208,207,
+  206,205,204,203,202,201,200,199,198,197,196,195,194,193,192,191,
+  190,189,188,187,186,185,184,183,182,181,180,179,178,177,176,175,
+  174,173,172,171,170,169,168,167,166,165,164,163,162,161,160,159,
+  158,157,156,155,154,153,152,151,150,149,148,147,146,145,144,143,
+  142,141,140,139,138,137,136,135,134,133,132,131,130,129,128,127,
+  126,125,124,123,122,121,120,119,118,117,116,115,114,113,112,111,
+  110,109,108,107,106,105,104,103,102,101,100, 99, 98, 97, 96, 95,
+   94, 93, 92, 91, 90, 89, 88, 87, 86, 85, 84, 83, 82, 81, 80, 79,
+   78, 77, 76, 75, 74, 73, 72, 71, 70, 69, 68, 67, 66, 65, 64, 63,
+   62, 61, 60, 59, 58, 57, 56, 55, 54, 53, 52, 51, 50, 49, 48, 47,
+   46, 45, 44, 43, 42, 41, 40, 39, 38, 37, 36, 35, 34, 33, 32, 31,
+   30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17, 16, 15,
+   14, 13, 12, 11, 10,  9,  8,  7,  6,  5,  4,  3,  2,  1,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+    0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  1,  2,  3,
+    4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19,
+   20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35,
+   36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51,
+   52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63, 64, 65, 66, 67,
+   68, 69, 70, 71, 72, 73, 74, 75, 76, 77, 78, 79, 80, 81, 82, 83,
+   84, 85, 86, 87, 88, 89, 90, 91, 92, 93, 94, 95, 96, 97, 98, 99,
+  100,101,102,103,104,105,106,107,108,109,110,111,112,113,114,115,
+  116,117,118,119,120,121,122,123,124,125,126,127,128,129,130,131,
+  132,133,134,135,136,137,138,139,140,141,142,143,144,145,146,147,
+  148,149,150,151,152,153,154,155,156,157,158,159,160,161,162,163,
+  164,165,166,167,168,169,170,171,172,173,174,175,176,177,178,179,
+  180,181,182,183,184,185,186,187,188,189,190,191,192,193,194,195,
+  196,197,198,199,200,201,202,203,204,205,206,207,208,209,210,211,
+  212,213,214,215,216,217,218,219,220,221,222,223,224,225,226,227,
+  228,229,230,231,232,233,234,235,236,237,238,239,240,241,242,243,
+  244,245,246,247,248,249,250,251,252,253,254,255,255,255,255,255,
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+  255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,
+  255,255,255,255,255,255,255,255,255,255};
+
+// Wheel() for every position, so it's a single read instead of branchy 8 bit math
+static const uint32_t PROGMEM _WheelTable[256] = {
+  0xFF0000, 0xFC0300, 0xF90600, 0xF60900, 0xF30C00, 0xF00F00, 0xED1200, 0xEA1500,
+  0xE71800, 0xE41B00, 0xE11E00, 0xDE2100, 0xDB2400, 0xD82700, 0xD52A00, 0xD22D00,
+  0xCF3000, 0xCC3300, 0xC93600, 0xC63900, 0xC33C00, 0xC03F00, 0xBD4200, 0xBA4500,
+  0xB74800, 0xB44B00, 0xB14E00, 0xAE5100, 0xAB5400, 0xA85700, 0xA55A00, 0xA25D00,
+  0x9F6000, 0x9C6300, 0x996600, 0x966900, 0x936C00, 0x906F00, 0x8D7200, 0x8A7500,
+  0x877800, 0x847B00, 0x817E00, 0x7E8100, 0x7B8400, 0x788700, 0x758A00, 0x728D00,
+  0x6F9000, 0x6C9300, 0x699600, 0x669900, 0x639C00, 0x609F00, 0x5DA200, 0x5AA500,
+  0x57A800, 0x54AB00, 0x51AE00, 0x4EB100, 0x4BB400, 0x48B700, 0x45BA00, 0x42BD00,
+  0x3FC000, 0x3CC300, 0x39C600, 0x36C900, 0x33CC00, 0x30CF00, 0x2DD200, 0x2AD500,
+  0x27D800, 0x24DB00, 0x21DE00, 0x1EE100, 0x1BE400, 0x18E700, 0x15EA00, 0x12ED00,
+  0x0FF000, 0x0CF300, 0x09F600, 0x06F900, 0x03FC00, 0x00FF00, 0x00FC03, 0x00F906,
+  0x00F609, 0x00F30C, 0x00F00F, 0x00ED12, 0x00EA15, 0x00E718, 0x00E41B, 0x00E11E,
+  0x00DE21, 0x00DB24, 0x00D827, 0x00D52A, 0x00D22D, 0x00CF30, 0x00CC33, 0x00C936,
+  0x00C639, 0x00C33C, 0x00C03F, 0x00BD42, 0x00BA45, 0x00B748, 0x00B44B, 0x00B14E,
+  0x00AE51, 0x00AB54, 0x00A857, 0x00A55A, 0x00A25D, 0x009F60, 0x009C63, 0x009966,
+  0x009669, 0x00936C, 0x00906F, 0x008D72, 0x008A75, 0x008778, 0x00847B, 0x00817E,
+  0x007E81, 0x007B84, 0x007887, 0x00758A, 0x00728D, 0x006F90, 0x006C93, 0x006996,
+  0x006699, 0x00639C, 0x00609F, 0x005DA2, 0x005AA5, 0x0057A8, 0x0054AB, 0x0051AE,
+  0x004EB1, 0x004BB4, 0x0048B7, 0x0045BA, 0x0042BD, 0x003FC0, 0x003CC3, 0x0039C6,
+  0x0036C9, 0x0033CC, 0x0030CF, 0x002DD2, 0x002AD5, 0x0027D8, 0x0024DB, 0x0021DE,
+  0x001EE1, 0x001BE4, 0x0018E7, 0x0015EA, 0x0012ED, 0x000FF0, 0x000CF3, 0x0009F6,
+  0x0006F9, 0x0003FC, 0x0000FF, 0x0300FC, 0x0600F9, 0x0900F6, 0x0C00F3, 0x0F00F0,
+  0x1200ED, 0x1500EA, 0x1800E7, 0x1B00E4, 0x1E00E1, 0x2100DE, 0x2400DB, 0x2700D8,
+  0x2A00D5, 0x2D00D2, 0x3000CF, 0x3300CC, 0x3600C9, 0x3900C6, 0x3C00C3, 0x3F00C0,
+  0x4200BD, 0x4500BA, 0x4800B7, 0x4B00B4, 0x4E00B1, 0x5100AE, 0x5400AB, 0x5700A8,
+  0x5A00A5, 0x5D00A2, 0x60009F, 0x63009C, 0x660099, 0x690096, 0x6C0093, 0x6F0090,
+  0x72008D, 0x75008A, 0x780087, 0x7B0084, 0x7E0081, 0x81007E, 0x84007B, 0x870078,
+  0x8A0075, 0x8D0072, 0x90006F, 0x93006C, 0x960069, 0x990066, 0x9C0063, 0x9F0060,
+  0xA2005D, 0xA5005A, 0xA80057, 0xAB0054, 0xAE0051, 0xB1004E, 0xB4004B, 0xB70048,
+  0xBA0045, 0xBD0042, 0xC0003F, 0xC3003C, 0xC60039, 0xC90036, 0xCC0033, 0xCF0030,
+  0xD2002D, 0xD5002A, 0xD80027, 0xDB0024, 0xDE0021, 0xE1001E, 0xE4001B, 0xE70018,
+  0xEA0015, 0xED0012, 0xF0000F, 0xF3000C, 0xF60009, 0xF90006, 0xFC0003, 0xFF0000};
+
 uint32_t X7Segment::ColorHSV(uint16_t hue, uint8_t sat, uint8_t val) {
 
   uint8_t r, g, b;
@@ -267,11 +657,12 @@ uint32_t X7Segment::ColorHSV(uint16_t hue, uint8_t sat, uint8_t val) {
   // (not 1536, more on that below), but the full unsigned 16-bit type was
   // chosen for hue so that one's code can easily handle a contiguous color
   // wheel by allowing hue to roll over in either direction.
-  hue = (hue * 1530L + 32768) / 65536;
+  // Unsigned with a shift, as the value can never be negative.
+  uint16_t h = ((uint32_t)hue * 1530 + 32768) >> 16;
   // Because red is centered on the rollover point (the +32768 above,
   // essentially a fixed-point +0.5), the above actually yields 0 to 1530,
-  // where 0 and 1530 would yield the same thing. Rather than apply a
-  // costly modulo operator, 1530 is handled as a special case below.
+  // where 0 and 1530 would yield the same thing.
+  if(h >= 1530) h = 0;
 
   // So you'd think that the color "hexcone" (the thing that ramps from
   // pure red, to pure yellow, to pure green and so forth back to red,
@@ -287,40 +678,17 @@ uint32_t X7Segment::ColorHSV(uint16_t hue, uint8_t sat, uint8_t val) {
   // Pure yellow to not-quite-pure-green is: 255, 255, 0 to   1, 255,   0
   // Pure green to not-quite-pure-cyan is:     0, 255, 0 to   0, 255, 254
   // and so forth. Hence, 1530 distinct hues (0 to 1529), and hence why
-  // the constants below are not the multiples of 256 you might expect.
-
-  // Convert hue to R,G,B (nested ifs faster than divide+mod+switch):
-  if(hue < 510) {         // Red to Green-1
-    b = 0;
-    if(hue < 255) {       //   Red to Yellow-1
-      r = 255;
-      g = hue;            //     g = 0 to 254
-    } else {              //   Yellow to Green-1
-      r = 510 - hue;      //     r = 255 to 1
-      g = 255;
-    }
-  } else if(hue < 1020) { // Green to Blue-1
-    r = 0;
-    if(hue <  765) {      //   Green to Cyan-1
-      g = 255;
-      b = hue - 510;      //     b = 0 to 254
-    } else {              //   Cyan to Blue-1
-      g = 1020 - hue;     //     g = 255 to 1
-      b = 255;
-    }
-  } else if(hue < 1530) { // Blue to Red-1
-    g = 0;
-    if(hue < 1275) {      //   Blue to Magenta-1
-      r = hue - 1020;     //     r = 0 to 254
-      b = 255;
-    } else {              //   Magenta to Red-1
-      r = 255;
-      b = 1530 - hue;     //     b = 255 to 1
-    }
-  } else {                // Last 0.5 Red (quicker than % operator)
-    r = 255;
-    g = b = 0;
-  }
+  // the table is 1530 long and not a multiple of 256.
+
+  // Each channel is the same ramp, offset around the wheel:
+  uint16_t hg = h + 1020;
+  if(hg >= 1530) hg -= 1530;
+  uint16_t hb = h + 510;
+  if(hb >= 1530) hb -= 1530;
+
+  r = pgm_read_byte(&_HueRampTable[h]);
+  g = pgm_read_byte(&_HueRampTable[hg]);
+  b = pgm_read_byte(&_HueRampTable[hb]);
 
   // Apply saturation and value to R,G,B, pack into 32-bit result:
   uint32_t v1 =   1 + val; // 1 to 256; allows >>8 instead of /255
@@ -331,44 +699,153 @@ uint32_t X7Segment::ColorHSV(uint16_t hue, uint8_t sat, uint8_t val) {
          ( ((((b * s1) >> 8) + s2) * v1)           >> 8);
 }
 
+// Fill colors[] with count colors, stepping the hue by step each time
+// Walks the 1530 step wheel in 16.16 fixed point, hue * 1530 wrapping at 65536 * 1530, so each entry
+// is three reads a small step along the table from the last, with the same rounding as ColorHSV()
+void X7Segment::ColorHSVRamp( uint32_t *colors, uint16_t count, uint16_t hue, int16_t step, uint8_t sat, uint8_t val )
+{
+	const uint32_t wrap = 1530UL << 16;
+	uint32_t pos = (uint32_t)hue * 1530;
+	uint32_t posStep = (uint32_t)(uint16_t)step * 1530;
+
+	uint32_t v1 =   1 + val;
+	uint16_t s1 =   1 + sat;
+	uint8_t  s2 = 255 - sat;
+	bool full = ( sat == 255 && val == 255 );
+
+	for ( uint16_t i = 0; i < count; i++ )
+	{
+		uint16_t h = ( pos + 32768 ) >> 16;
+		if ( h >= 1530 ) h = 0;
+
+		uint16_t hg = h + 1020;
+		if ( hg >= 1530 ) hg -= 1530;
+		uint16_t hb = h + 510;
+		if ( hb >= 1530 ) hb -= 1530;
+
+		uint8_t r = pgm_read_byte( &_HueRampTable[h] );
+		uint8_t g = pgm_read_byte( &_HueRampTable[hg] );
+		uint8_t b = pgm_read_byte( &_HueRampTable[hb] );
+
+		// Full saturation and value leave the channels as they are
+		if ( full )
+			colors[i] = ( (uint32_t)r << 16 ) | ( (uint16_t)g << 8 ) | b;
+		else
+			colors[i] = ((((((r * s1) >> 8) + s2) * v1) & 0xff00) << 8) |
+						 (((((g * s1) >> 8) + s2) * v1) & 0xff00)       |
+						( ((((b * s1) >> 8) + s2) * v1)           >> 8);
+
+		pos += posStep;
+		if ( pos >= wrap ) pos -= wrap;
+	}
+}
+
+// Fill colors[] with count Wheel() colors, stepping the position by step each time
+void X7Segment::WheelRamp( uint32_t *colors, uint16_t count, uint8_t start, uint8_t step )
+{
+	for ( uint16_t i = 0; i < count; i++ )
+	{
+		colors[i] = pgm_read_dword( &_WheelTable[ start ] );
+		start += step;
+	}
+}
+
 
 void X7Segment::CheckToCacheBytes( String str )
 {
-	if ( str != cachedString )
+	// Re-cache if the text changed, or a glyph was defined since we last cached it
+	if ( !cacheValid || str != cachedString || cachedGeneration != glyphGeneration )
 	{
 		cachedString = str;
+		cachedGeneration = glyphGeneration;
+		cacheValid = true;
 		
 		int index = 0;
 		for ( int s = 0; s < str.length(); s++ )
 		{
+			// Characters past the last board are still counted, but can't be cached
 			if ( (String)str.charAt(s) != "." )
 			{ 
-				cachedBytes[index] = FindByteForCharater( (String)str.charAt(s) );
+				if ( index < dispCount )
+					cachedBytes[index] = FindByteForCharater( str.charAt(s) );
 				index++;
 			}
-			else if ( s > 0 && bitRead( cachedBytes[index-1], 7 ) != 1 )
+			else if ( s > 0 && index <= dispCount && bitRead( cachedBytes[index-1], 7 ) != 1 )
 			{
 				cachedBytes[index-1] = cachedBytes[index-1] | 0b10000000;
 			}
 			else
 			{
-				cachedBytes[index] = 0b10000000;
+				if ( index < dispCount )
+					cachedBytes[index] = 0b10000000;
 				index++;
 			}
 		}
+
+		// Decimal points don't take a digit, so this can be shorter than the text
+		cachedLength = min( index, (int)dispCount );
+
+		// Blank anything left over from longer text
+		for ( int i = cachedLength; i < dispCount; i++ )
+			cachedBytes[i] = 0;
 	}
 }
 
 
 
 void X7Segment::FillBuffer()
+{
+	if ( PrepareBuffer() )
+		TransmitBuffer();
+}
+
+// Everything up to sending the frame - the governor, capture and encoding. X7SegmentCanvas calls this for
+// every row before it transmits any of them. Returns false if the governor is holding the frame back.
+bool X7Segment::PrepareBuffer()
+{
+	uint32_t start = micros();
+
+	// The chain is still clocking out the last frame, so hold on to this one and Tick() sends it when
+	// the chain is free. Anything drawn before then replaces it, so only the latest frame goes out.
+	if ( governorEnabled && start - lastFrameMicros < GetFrameMicros() )
+	{
+		frameDeferred = true;
+		return false;
+	}
+
+	frameDeferred = false;
+
+	if ( capture != NULL )
+		capture->Capture( leds, ledCount, brightness );
+
+	// Waiting for the wire is part of sending, so it is counted as transmit time rather than encode time
+	uint32_t waitStart = micros();
+	WaitForTransmit();
+	waitMicros = micros() - waitStart;
+
+	EncodeBuffer();
+
+	encodeMicros = micros() - start - waitMicros;
+	return true;
+}
+
+// rmtWrite() doesn't block, so wait for the last frame to finish clocking out before led_data is encoded over
+void X7Segment::WaitForTransmit()
+{
+	#if defined(ESP32)
+		while ( rmt_send != NULL && micros() - lastFrameMicros < GetFrameMicros() )
+			;
+	#endif
+}
+
+// Convert leds[] into whatever the output backend sends
+void X7Segment::EncodeBuffer()
 {
     #if defined(ESP32)
 
     uint16_t led;
     int col, bit, col_inner;
     int i=0;
-    uint16_t num_all_bits = 24 * ledCount;
     int color[] = {0,0,0};
 
     for ( led=0; led < ledCount; led++ )
@@ -401,21 +878,81 @@ void X7Segment::FillBuffer()
         }
     }
 
-    // Send the data
-    rmtWrite(rmt_send, led_data, num_all_bits);
-
-
     #else
 
         for ( uint16_t i = 0; i < ledCount; i++ )
         {
             pixels.setPixelColor( i, leds[ i ] );
         }
+
+    #endif
+}
+
+// Clock the encoded frame out to the boards
+void X7Segment::TransmitBuffer()
+{
+	uint32_t start = micros();
+
+	// A scheduler sends the frame in its next transmit window instead
+	if ( scheduler != NULL )
+		framePending = true;
+	else
+		SendBuffer();
+
+	transmitMicros = waitMicros + ( micros() - start );
+}
+
+void X7Segment::SendBuffer()
+{
+	// Stamped here rather than when the frame was drawn, as a scheduler can send it some time later
+	lastFrameMicros = micros();
+
+    #if defined(ESP32)
+
+    uint32_t num_all_bits = 24 * (uint32_t)ledCount;
+
+    // Send the data
+    rmtWrite(rmt_send, led_data, num_all_bits);
+
+    #else
+
         pixels.show();
 
     #endif
 }
 
+// Time it takes to clock a whole frame out to the chain, including the latch at the end
+uint32_t X7Segment::GetFrameMicros()
+{
+	return ( (uint32_t)ledCount * X7SEGMENT_MICROS_PER_LED ) + X7SEGMENT_LATCH_MICROS;
+}
+
+// The most frames per second the chain can physically show
+float X7Segment::GetMaxFPS()
+{
+	return 1000000.0 / GetFrameMicros();
+}
+
+void X7Segment::SetFrameGovernor( bool enable )
+{
+	governorEnabled = enable;
+}
+
+void X7Segment::SetFrameReadyCallback( X7SegmentFrameCallback callback )
+{
+	frameCallback = callback;
+}
+
+uint32_t X7Segment::GetLastEncodeMicros()
+{
+	return encodeMicros;
+}
+
+uint32_t X7Segment::GetLastTransmitMicros()
+{
+	return transmitMicros;
+}
+
 
 void X7Segment::DisplayTextVerticalRainbow( String text, uint32_t colorA, uint32_t colorB )
 {
@@ -426,8 +963,8 @@ void X7Segment::DisplayTextVerticalRainbow( String text, uint32_t colorA, uint32
     ClearBuffer();
     uint16_t ledIndex = 0;
 
-	// Clamp the length, so text longer than the display count is ignored
-	int lengthOfLoop = min( dispCount, (uint8_t)text.length() );
+	// Only the digits that were cached, so text longer than the display count is ignored
+	int lengthOfLoop = cachedLength;
 
 	uint32_t color;
 	
@@ -481,8 +1018,8 @@ void X7Segment::DisplayTextHorizontalRainbow( String text, uint32_t colorA, uint
 
 	uint32_t color;
 
-	// Clamp the length, so text longer than the display count is ignored
-	int lengthOfLoop = min( dispCount, (uint8_t)text.length() );
+	// Only the digits that were cached, so text longer than the display count is ignored
+	int lengthOfLoop = cachedLength;
 	
 	// Grab the byte (bits) for the segments for the character passed in
 	for ( int s = 0; s < lengthOfLoop; s++ )
@@ -530,10 +1067,12 @@ void X7Segment::DisplayTextColorCycle( String text, uint8_t index )
     ClearBuffer();
     uint16_t ledIndex = 0;
 
-	// Clamp the length, so text longer than the display count is ignored
-	int lengthOfLoop = min( dispCount, (uint8_t)text.length() );
+	// Only the digits that were cached, so text longer than the display count is ignored
+	int lengthOfLoop = cachedLength;
 
-	uint32_t color;
+	// Every board uses the same ramp of colors, so look them up once
+	uint32_t colors[ NUM_PIXELS_PER_BOARD - 1 ];
+	WheelRamp( colors, NUM_PIXELS_PER_BOARD - 1, index, (255/28) );
 	
 	// Grab the byte (bits) for the segments for the character passed in
 	for ( int s = 0; s < lengthOfLoop; s++ )
@@ -542,21 +1081,21 @@ void X7Segment::DisplayTextColorCycle( String text, uint8_t index )
 		
 		if(code > -1)
 		{
-			int colorStart = index;
+			int pixelIndex = 0;
 				
 			for( int segment = 0; segment < 7; segment++ )
 			{
 				bool on = ( bitRead( code, segment) == 1 );
 				for ( int p = 0; p < NUM_PIXELS_PER_SEGMENT; p++ )
 				{
-					color = Wheel( colorStart & 255 );
-					leds[ ledIndex++ ] = ( on ? color : Color(0,0,0) );
-					colorStart+=(255/28);	
+					leds[ ledIndex++ ] = ( on ? colors[ pixelIndex ] : Color(0,0,0) );
+					pixelIndex++;
 				}
 			}
 
+			// The decimal point takes the color of the last segment pixel
 			bool on = ( bitRead( code, 7) == 1 );
-			leds[ ledIndex++ ] = ( on ? color : Color(0,0,0) );
+			leds[ ledIndex++ ] = ( on ? colors[ pixelIndex - 1 ] : Color(0,0,0) );
 		}
 	}
 
@@ -575,8 +1114,8 @@ void X7Segment::DisplayTextColor( String text, uint32_t color )
     ClearBuffer();
     uint16_t ledIndex = 0;
 	
-	// Clamp the length, so text longer than the display count is ignored
-	int lengthOfLoop = min( dispCount, (uint8_t)text.length() );
+	// Only the digits that were cached, so text longer than the display count is ignored
+	int lengthOfLoop = cachedLength;
 
 	// Grab the byte (bits) for the segments for the character passed in
 	for ( int s = 0; s < lengthOfLoop; s++ )
@@ -614,6 +1153,7 @@ void X7Segment::DisplayTime( uint8_t hours, uint8_t mins, uint8_t secs, uint32_t
 			text = " " + text;
 	}
 
+	CheckToCacheBytes( text );
     ClearBuffer();
     uint16_t ledIndex = 0;
 
@@ -622,8 +1162,8 @@ void X7Segment::DisplayTime( uint8_t hours, uint8_t mins, uint8_t secs, uint32_t
 	uint8_t b = Blue( colorM ) * 0.5;
 	uint32_t colorM2 = Color( r, g, b );
 	
-	// Clamp the length, so text longer than the display count is ignored
-	int lengthOfLoop = min( dispCount, (uint8_t)text.length() );
+	// Only the digits that were cached, so text longer than the display count is ignored
+	int lengthOfLoop = cachedLength;
 
 	// Grab the byte (bits) for the segments for the character passed in
 	for ( int s = 0; s < lengthOfLoop; s++ )
@@ -655,36 +1195,193 @@ void X7Segment::DisplayTime( uint8_t hours, uint8_t mins, uint8_t secs, uint32_t
 	FillBuffer();
 }
 
-int X7Segment::FindIndexOfChar(String character)
+void X7Segment::SetDigit( uint8_t index, byte segments, uint32_t color )
+{
+	if ( !isReady || index >= dispCount )
+		return;
+
+	// The cached bytes no longer match any string, so force the next Display* call to re-cache
+	cacheValid = false;
+	cachedBytes[index] = segments;
+
+	uint16_t ledIndex = index * NUM_PIXELS_PER_BOARD;
+
+	for( int segment = 0; segment < 7; segment++ )
+	{
+		bool on = ( bitRead( segments, segment) == 1 );
+		for ( int p = 0; p < NUM_PIXELS_PER_SEGMENT; p++ )
+			leds[ ledIndex++ ] = ( on ? color : Color(0,0,0) );
+	}
+
+	bool on = ( bitRead( segments, 7) == 1 );
+	leds[ ledIndex ] = ( on ? color : Color(0,0,0) );
+}
+
+void X7Segment::Show()
+{
+	if ( !isReady )
+		return;
+
+	FillBuffer();
+}
+
+void X7Segment::ShowFrame( const uint32_t *frame )
+{
+	if ( !isReady )
+		return;
+
+	memcpy( leds, frame, ledCount * sizeof(uint32_t) );
+	FillBuffer();
+}
+
+int X7Segment::FindPixelAtXY( uint8_t x, uint8_t y )
 {
-	String s = character;
-	s.toLowerCase();
-	for(int i=0; i< ARRAY_SIZE; i++)
+	for ( int p = 0; p < NUM_PIXELS_PER_BOARD; p++ )
 	{
-		if( s.equals( (String)( (char)available_codes[i][0] ) ) )
-			return i;
+		if ( pixelsXY[p][0] == x && pixelsXY[p][1] == y )
+			return p;
 	}
 	return -1;
 }
 
-byte X7Segment::FindByteForCharater( String character )
+void X7Segment::RenderASCII( Print &out )
 {
-	String s = character;
-	s.toLowerCase();
-	for(int i=0; i< ARRAY_SIZE; i++)
+	for ( uint8_t y = 0; y < NUM_ROWS_PER_BOARD; y++ )
 	{
-		if ( isForcedUpper )
+		for ( uint8_t board = 0; board < dispCount; board++ )
 		{
-			if( s.equals( (String)( (char)available_codes_upper[i][0] ) ) )
-				return available_codes_upper[i][1];
+			for ( uint8_t x = 0; x < NUM_COLUMNS_PER_BOARD; x++ )
+			{
+				int p = FindPixelAtXY( x, y );
+				char c = ' ';
+
+				if ( p >= 0 && leds[ board * NUM_PIXELS_PER_BOARD + p ] != 0 )
+				{
+					int segment = p / NUM_PIXELS_PER_SEGMENT;
+
+					// Segments a, d and g run across the board, the rest run down it
+					if ( segment == 7 )
+						c = '.';
+					else if ( segment == 0 || segment == 3 || segment == 6 )
+						c = '-';
+					else
+						c = '|';
+				}
+				out.print( c );
+			}
 		}
-		else
+		out.println();
+	}
+}
+
+void X7Segment::RenderPPM( Print &out, uint8_t scale )
+{
+	uint16_t width = dispCount * NUM_COLUMNS_PER_BOARD * scale;
+	uint16_t height = NUM_ROWS_PER_BOARD * scale;
+
+	out.print( "P6\n" );
+	out.print( width );
+	out.print( ' ' );
+	out.print( height );
+	out.print( "\n255\n" );
+
+	for ( uint16_t py = 0; py < height; py++ )
+	{
+		for ( uint16_t px = 0; px < width; px++ )
 		{
-			if( s.equals( (String)( (char)available_codes[i][0] ) ) )
-				return available_codes[i][1];
+			uint8_t board = px / ( NUM_COLUMNS_PER_BOARD * scale );
+			int p = FindPixelAtXY( ( px / scale ) % NUM_COLUMNS_PER_BOARD, py / scale );
+			uint32_t col = ( p >= 0 ) ? leds[ board * NUM_PIXELS_PER_BOARD + p ] : 0;
+
+			out.write( Red( col ) );
+			out.write( Green( col ) );
+			out.write( Blue( col ) );
 		}
 	}
-	return -1;
+}
+
+// CRC-32 of the frame as R,G,B bytes, so two frames can be compared without keeping a copy
+uint32_t X7Segment::GetFrameCRC()
+{
+	uint32_t crc = 0xFFFFFFFF;
+
+	for ( uint16_t i = 0; i < ledCount; i++ )
+	{
+		uint8_t rgb[3] = { Red( leds[i] ), Green( leds[i] ), Blue( leds[i] ) };
+
+		for ( uint8_t c = 0; c < 3; c++ )
+		{
+			crc ^= rgb[c];
+			for ( uint8_t bit = 0; bit < 8; bit++ )
+				crc = ( crc >> 1 ) ^ ( 0xEDB88320 & ( 0 - ( crc & 1 ) ) );
+		}
+	}
+
+	return ~crc;
+}
+
+void X7Segment::SetupCharacters()
+{
+	if ( glyphsReady )
+		return;
+
+	memset( glyphSlot, 0, GLYPH_TABLE_SIZE );
+	glyphs[0] = glyphs_upper[0] = GLYPH_UNDEFINED;
+	glyph_chars[0] = 0;
+	glyphsReady = true;
+
+	for ( int i = 0; i < ARRAY_SIZE; i++ )
+		DefineGlyph( pgm_read_byte( &available_codes[i][0] ), pgm_read_byte( &available_codes[i][1] ), pgm_read_byte( &available_codes_upper[i][1] ) );
+}
+
+bool X7Segment::DefineGlyph( char character, byte segments )
+{
+	return DefineGlyph( character, segments, segments );
+}
+
+bool X7Segment::DefineGlyph( char character, byte segments, byte upperSegments )
+{
+	SetupCharacters();
+
+	// CheckToCacheBytes() always turns '.' into the decimal point, so a glyph for it would never be drawn
+	if ( character == '.' )
+		return false;
+
+	// Through uint8_t first, as tolower() of a negative char is undefined and the table covers every byte
+	uint8_t lower = tolower( (uint8_t)character );
+	uint8_t upper = toupper( (uint8_t)character );
+
+	// New characters take the next slot, which is also their place in the list GetCharacterAtArrayIndex() walks
+	uint8_t slot = FindIndexOfChar( lower ) + 1;
+	if ( slot == 0 )
+	{
+		if ( glyphCount >= X7SEGMENT_MAX_GLYPHS )
+			return false;
+
+		slot = ++glyphCount;
+		glyph_chars[ slot ] = lower;
+
+		// Both cases point at the slot, so lookup doesn't have to lowercase the character first
+		glyphSlot[ lower ] = glyphSlot[ upper ] = slot;
+	}
+
+	glyphs[ slot ] = segments;
+	glyphs_upper[ slot ] = upperSegments;
+
+	// Any display that cached text with the old glyph needs to re-cache it
+	glyphGeneration++;
+
+	return true;
+}
+
+int X7Segment::FindIndexOfChar( char character )
+{
+	return glyphSlot[ (uint8_t)character ] - 1;
+}
+
+byte X7Segment::FindByteForCharater( char character )
+{
+	return glyphTable[ glyphSlot[ (uint8_t)character ] ];
 }
 
 String X7Segment::PadTimeData( int8_t data )
@@ -699,18 +1396,7 @@ String X7Segment::PadTimeData( int8_t data )
 // The colours are a transition r - g - b - back to r.
 uint32_t X7Segment::Wheel(byte WheelPos )
 {
-	WheelPos = 255 - WheelPos;
-	if(WheelPos < 85)
-		return Color(255 - WheelPos * 3, 0, WheelPos * 3);
-
-	if(WheelPos < 170)
-	{
-		WheelPos -= 85;
-		return Color(0, WheelPos * 3, 255 - WheelPos * 3);
-	}
-	
-	WheelPos -= 170;
-	return Color(WheelPos * 3, 255 - WheelPos * 3, 0);
+	return pgm_read_dword( &_WheelTable[ WheelPos ] );
 }
 
 uint8_t X7Segment::Red( uint32_t col )
@@ -731,8 +1417,12 @@ uint8_t X7Segment::Blue( uint32_t col )
 
 uint8_t X7Segment::AdjustForBrightness( uint8_t col )
 {
-    uint8_t col_fixed = round( (float)col * ( (float)brightness/255.0 ) );
-	return col_fixed;
+	#if defined(ESP32)
+		return brightnessLUT[ col ];
+	#else
+		uint8_t col_fixed = round( (float)col * ( (float)brightness/255.0 ) );
+		return col_fixed;
+	#endif
 }
 
 
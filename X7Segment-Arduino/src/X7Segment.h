@@ -54,7 +54,23 @@
         #include <WProgram.h>
         #include <pins_arduino.h>
     #endif
+
+    #include "X7SegmentSink.h"
 	
+    // Board geometry - 7 segments of 2 pixels plus the decimal point, laid out on a 6 x 8 grid including the gap to the next board
+    #define NUM_PIXELS_PER_BOARD 15
+    #define NUM_PIXELS_PER_SEGMENT 2
+    #define NUM_COLUMNS_PER_BOARD 6
+    #define NUM_ROWS_PER_BOARD 8
+
+    // WS2812 timing - 24 bits of 1.25us per pixel, then the line is held low to latch the frame
+    #define X7SEGMENT_MICROS_PER_LED 30
+    #define X7SEGMENT_LATCH_MICROS 50
+
+    // Most glyphs there is room for, counting the built in ones - DefineGlyph() returns false past this
+    #ifndef X7SEGMENT_MAX_GLYPHS
+        #define X7SEGMENT_MAX_GLYPHS 64
+    #endif
 
     static const uint8_t PROGMEM _NeoPixelGammaTable[256] = {
     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
@@ -74,7 +90,15 @@
   182,184,186,188,191,193,195,197,199,202,204,206,209,211,213,215,
   218,220,223,225,227,230,232,235,237,240,242,245,247,250,252,255};
 
-class X7Segment
+class X7SegmentCapture;
+class X7SegmentReplay;
+class X7SegmentCanvas;
+class X7SegmentScheduler;
+class X7Segment;
+
+typedef void (*X7SegmentFrameCallback)( X7Segment &display );
+
+class X7Segment : public X7SegmentSink
 {
 	public:
 		X7Segment( uint8_t displayCount, uint8_t dPin );
@@ -82,15 +106,49 @@ class X7Segment
 		
 		void Begin( uint8_t brightness );
 		void SetBrightness( uint8_t brightness );
+
+		// Non blocking fades - these only re-send the current frame at a new brightness, so call Tick() every loop()
+		void FadeTo( uint8_t brightness, uint32_t duration );
+		void FadeText( String text, uint32_t color, uint32_t duration );
+		void Pulse( uint8_t low, uint8_t high, uint32_t period );
+		void StopFade();
+		bool IsFading();
+		void Tick();
 		  
 		void DisplayTextVerticalRainbow( String text, uint32_t colorA, uint32_t colorB );
 		void DisplayTextHorizontalRainbow( String text, uint32_t colorA, uint32_t colorB );
 		void DisplayTextColor( String text, uint32_t color );
 		void DisplayTextColorCycle( String text, uint8_t index );
 		void DisplayTime( uint8_t hours, uint8_t mins, uint8_t secs, uint32_t colorH, uint32_t colorM );
+
+		// Raw segment access - X7SegmentStream decodes frames straight into the display through these
+		void SetDigit( uint8_t index, byte segments, uint32_t color );
+		void Show();
+		void ShowFrame( const uint32_t *frame );
+
+		// Optional hook that is handed every frame as it is sent out
+		void SetCapture( X7SegmentCapture *cap );
+
+		// Draw the current frame laid out like the boards, for checking output without the hardware
+		void RenderASCII( Print &out );
+		void RenderPPM( Print &out, uint8_t scale = 4 );
+		uint32_t GetFrameCRC();
+
+		// How long the last frame took to encode for the backend, and to send to the boards. Sending
+		// includes waiting for the frame before it to finish clocking out.
+		uint32_t GetLastEncodeMicros();
+		uint32_t GetLastTransmitMicros();
+		uint32_t GetFrameMicros();
+
+		// Frames drawn faster than the chain can show them are coalesced, and only the latest is sent by Tick()
+		float GetMaxFPS();
+		void SetFrameGovernor( bool enable );
+		void SetFrameReadyCallback( X7SegmentFrameCallback callback );
 		
 	    static uint32_t Color(uint8_t r, uint8_t g, uint8_t b);
         static uint32_t ColorHSV(uint16_t hue, uint8_t sat=255, uint8_t val=255);
+        static void ColorHSVRamp(uint32_t *colors, uint16_t count, uint16_t hue, int16_t step, uint8_t sat=255, uint8_t val=255);
+        static void WheelRamp(uint32_t *colors, uint16_t count, uint8_t start, uint8_t step);
         static uint32_t gamma32(uint32_t x);
 
         static uint8_t  gamma8(uint8_t x) {
@@ -100,14 +158,25 @@ class X7Segment
 		uint32_t Wheel( byte WheelPos );
 
 		void ForceUppercase( bool force );
+
+		// Add a character, or replace how an existing one is drawn. Both upper and lower case map to the glyph.
+		// Returns false for '.', which is always drawn as the decimal point, or when there is no room left.
+		static bool DefineGlyph( char character, byte segments );
+		static bool DefineGlyph( char character, byte segments, byte upperSegments );
 		
 		bool IsReady( void );
 
+		uint8_t GetDisplayCount();
+		uint16_t GetLedCount();
 		byte GetArraySize();
 		String GetCharacterAtArrayIndex( int index );
 		
 	protected:
 
+		friend class X7SegmentCanvas;
+		friend class X7SegmentScheduler;
+		friend class X7SegmentReplay;
+
 		
 	private:
 
@@ -116,29 +185,64 @@ class X7Segment
         uint16_t ledCount;
         uint8_t brightness;
 
+		enum FadeMode { FADE_NONE, FADE_TO, FADE_TEXT, FADE_PULSE };
+		FadeMode fadeMode;
+		uint32_t fadeStart;
+		uint32_t fadeDuration;
+		uint8_t fadeFrom;
+		uint8_t fadeTarget;
+		String fadeText;
+		uint32_t fadeColor;
+		bool fadeSwapped;
+		void StepFade();
+
+		bool governorEnabled;
+		bool frameDeferred;
+		uint32_t lastFrameMicros;
+		uint32_t lastReadyMicros;
+		X7SegmentFrameCallback frameCallback;
+
         #if defined(ESP32)
             rmt_data_t* led_data;
             rmt_obj_t* rmt_send = NULL;
+            uint8_t brightnessLUT[256];
         #else
             Adafruit_NeoPixel pixels;
         #endif
 		
-		void SetupCharacters();
-		int FindIndexOfChar(String character);
-		byte FindByteForCharater( String character );
+		static void SetupCharacters();
+		static int FindIndexOfChar( char character );
+		int FindPixelAtXY( uint8_t x, uint8_t y );
+		byte FindByteForCharater( char character );
 		void CheckToCacheBytes( String s );
         void ClearBuffer();
         void FillBuffer();
+        bool PrepareBuffer();
+        void WaitForTransmit();
+        void EncodeBuffer();
+        void TransmitBuffer();
+        void SendBuffer();
 		String PadTimeData( int8_t data );
 		uint8_t Red( uint32_t col );
 		uint8_t Green( uint32_t col );
 		uint8_t Blue( uint32_t col );
         uint8_t AdjustForBrightness( uint8_t col );
+        void ApplyBrightness( uint8_t bright );
 		byte *cachedBytes;
         uint32_t *leds;
+		X7SegmentCapture *capture;
+		X7SegmentScheduler *scheduler;
+		bool framePending;
+		uint32_t encodeMicros;
+		uint32_t transmitMicros;
+		uint32_t waitMicros;
 		String cachedString;
+		uint8_t cachedLength;
+		bool cacheValid;
 		bool isReady;
 		bool isForcedUpper;
+		const byte *glyphTable;
+		uint32_t cachedGeneration;
 
 
 };
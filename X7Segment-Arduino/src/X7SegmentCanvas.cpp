@@ -0,0 +1,169 @@
+// ---------------------------------------------------------------------------
+// Created by Seon Rozenblum - seon@unexpectedmaker.com
+// Copyright 2019 License: MIT https://github.com/UnexpectedMaker/X7Segment/LICENSE
+//
+// See "X7SegmentCanvas.h" for purpose and syntax.
+// ---------------------------------------------------------------------------
+
+#include "X7SegmentCanvas.h"
+
+// Pixel positions on a single board, from X7Segment.cpp
+extern byte pixelsXY[ NUM_PIXELS_PER_BOARD ][2];
+
+X7SegmentCanvas::X7SegmentCanvas()
+{
+	rowCount = 0;
+	width = 0;
+	height = 0;
+	pixelX = NULL;
+	pixelY = NULL;
+	tableReady = false;
+}
+
+X7SegmentCanvas::~X7SegmentCanvas()
+{
+	free( pixelX );
+	free( pixelY );
+}
+
+bool X7SegmentCanvas::AddRow( X7Segment &row )
+{
+	if ( rowCount >= X7SEGMENT_CANVAS_MAX_ROWS )
+		return false;
+
+	textLength[ rowCount ] = 0;
+	rows[ rowCount++ ] = &row;
+
+	// The coordinate table doesn't cover the new row until Begin() is called again
+	tableReady = false;
+
+	return true;
+}
+
+uint16_t X7SegmentCanvas::GetWidth()
+{
+	return width;
+}
+
+uint16_t X7SegmentCanvas::GetHeight()
+{
+	return height;
+}
+
+uint8_t X7SegmentCanvas::GetRowCount()
+{
+	return rowCount;
+}
+
+bool X7SegmentCanvas::Begin()
+{
+	uint16_t totalLeds = 0;
+	width = 0;
+	tableReady = false;
+
+	for ( uint8_t r = 0; r < rowCount; r++ )
+	{
+		if ( !rows[r]->IsReady() )
+			return false;
+
+		totalLeds += rows[r]->ledCount;
+		width = max( width, (uint16_t)( rows[r]->dispCount * NUM_COLUMNS_PER_BOARD ) );
+	}
+
+	height = rowCount * NUM_ROWS_PER_BOARD;
+
+	free( pixelX );
+	free( pixelY );
+	pixelX = (uint16_t *) malloc( totalLeds * sizeof(uint16_t) );
+	pixelY = (uint16_t *) malloc( totalLeds * sizeof(uint16_t) );
+
+	if ( pixelX == NULL || pixelY == NULL )
+	{
+		free( pixelX );
+		free( pixelY );
+		pixelX = NULL;
+		pixelY = NULL;
+		return false;
+	}
+
+	// Work out where every pixel sits on the canvas once, so effects never have to
+	uint16_t i = 0;
+	for ( uint8_t r = 0; r < rowCount; r++ )
+	{
+		for ( uint8_t s = 0; s < rows[r]->dispCount; s++ )
+		{
+			for ( uint8_t p = 0; p < NUM_PIXELS_PER_BOARD; p++ )
+			{
+				pixelX[i] = pixelsXY[p][0] + ( NUM_COLUMNS_PER_BOARD * s );
+				pixelY[i] = pixelsXY[p][1] + ( NUM_ROWS_PER_BOARD * r );
+				i++;
+			}
+		}
+	}
+
+	tableReady = true;
+	return true;
+}
+
+void X7SegmentCanvas::SetRowText( uint8_t row, String text )
+{
+	if ( row >= rowCount || !rows[ row ]->IsReady() )
+		return;
+
+	rows[ row ]->CheckToCacheBytes( text );
+	textLength[ row ] = rows[ row ]->cachedLength;
+}
+
+void X7SegmentCanvas::Render( X7SegmentEffect effect )
+{
+	if ( !tableReady )
+		return;
+
+	uint16_t rowStart = 0;
+
+	for ( uint8_t r = 0; r < rowCount; r++ )
+	{
+		X7Segment *row = rows[r];
+		row->ClearBuffer();
+
+		for ( uint8_t s = 0; s < textLength[r]; s++ )
+		{
+			byte code = row->cachedBytes[s];
+			uint16_t ledIndex = s * NUM_PIXELS_PER_BOARD;
+
+			// Pixels 0-13 are the segments, 14 is the decimal point which is bit 7
+			for ( uint8_t p = 0; p < NUM_PIXELS_PER_BOARD; p++ )
+			{
+				uint8_t segment = ( p < 14 ) ? p / NUM_PIXELS_PER_SEGMENT : 7;
+
+				if ( bitRead( code, segment ) == 1 )
+				{
+					uint16_t i = rowStart + ledIndex + p;
+					row->leds[ ledIndex + p ] = effect( pixelX[i], pixelY[i], width, height );
+				}
+			}
+		}
+
+		rowStart += row->ledCount;
+	}
+
+	Show();
+}
+
+void X7SegmentCanvas::Show()
+{
+	bool prepared[ X7SEGMENT_CANVAS_MAX_ROWS ];
+
+	// Encode every row first, then send them back to back. On the ESP32 each row
+	// has its own RMT channel and rmtWrite() doesn't block, so the rows clock out
+	// at the same time. Other boards send each row in turn. Rows go through the
+	// same governor, capture and timing as X7Segment::Show().
+	for ( uint8_t r = 0; r < rowCount; r++ )
+		prepared[r] = rows[r]->IsReady() && rows[r]->PrepareBuffer();
+
+	for ( uint8_t r = 0; r < rowCount; r++ )
+	{
+		if ( prepared[r] )
+			rows[r]->TransmitBuffer();
+	}
+}
@@ -0,0 +1,64 @@
+// ---------------------------------------------------------------------------
+// Created by Seon Rozenblum - seon@unexpectedmaker.com
+// Copyright 2019 License: MIT https://github.com/UnexpectedMaker/X7Segment/LICENSE
+//
+// PURPOSE:
+// Treat several X7Segment chains, each on its own pin, as the rows of one big
+// wall of displays with a single X,Y coordinate space. Effects are evaluated
+// once over the whole canvas and written straight into each chain's buffer.
+//
+// SYNTAX:
+//   AddRow( display )          - Add an initialised X7Segment as the next row down
+//   Begin()                    - Build the pixel to canvas coordinate table, call again after adding more rows
+//   SetRowText( row, text )    - Set the text shown on a row
+//   Render( effect )           - Color every lit pixel on the canvas with the effect, and show it. Does nothing
+//                                until Begin() has succeeded for the current rows
+//   Show()                     - Send every row's buffer out again
+//
+//   An effect is a function that returns the color for a pixel:
+//     uint32_t MyEffect( uint16_t x, uint16_t y, uint16_t width, uint16_t height )
+// ---------------------------------------------------------------------------
+
+#ifndef X7SegmentCanvas_h
+	#define X7SegmentCanvas_h
+
+	#include "X7Segment.h"
+
+	#ifndef X7SEGMENT_CANVAS_MAX_ROWS
+		#define X7SEGMENT_CANVAS_MAX_ROWS 8
+	#endif
+
+	typedef uint32_t (*X7SegmentEffect)( uint16_t x, uint16_t y, uint16_t width, uint16_t height );
+
+class X7SegmentCanvas
+{
+	public:
+		X7SegmentCanvas();
+		~X7SegmentCanvas();
+
+		bool AddRow( X7Segment &row );
+		bool Begin();
+
+		uint16_t GetWidth();
+		uint16_t GetHeight();
+		uint8_t GetRowCount();
+
+		void SetRowText( uint8_t row, String text );
+		void Render( X7SegmentEffect effect );
+		void Show();
+
+	private:
+
+		X7Segment *rows[ X7SEGMENT_CANVAS_MAX_ROWS ];
+		uint8_t textLength[ X7SEGMENT_CANVAS_MAX_ROWS ];
+		uint8_t rowCount;
+
+		uint16_t width;
+		uint16_t height;
+
+		// Canvas X,Y for every pixel of every row, in the same order as the rows' leds[]
+		uint16_t *pixelX;
+		uint16_t *pixelY;
+		bool tableReady;
+};
+#endif
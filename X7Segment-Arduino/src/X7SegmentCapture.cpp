@@ -0,0 +1,341 @@
+// ---------------------------------------------------------------------------
+// Created by Seon Rozenblum - seon@unexpectedmaker.com
+// Copyright 2019 License: MIT https://github.com/UnexpectedMaker/X7Segment/LICENSE
+//
+// See "X7SegmentCapture.h" for purpose, log format and syntax.
+// ---------------------------------------------------------------------------
+
+#include "X7SegmentCapture.h"
+
+X7SegmentCapture::X7SegmentCapture( Print &out ) : log( out )
+{
+	previous = NULL;
+	ledCount = 0;
+	lastMillis = 0;
+	lastBrightness = 0;
+	frameCount = 0;
+	bytesWritten = 0;
+}
+
+X7SegmentCapture::~X7SegmentCapture()
+{
+	free( previous );
+}
+
+uint32_t X7SegmentCapture::GetFrameCount()
+{
+	return frameCount;
+}
+
+uint32_t X7SegmentCapture::GetBytesWritten()
+{
+	return bytesWritten;
+}
+
+void X7SegmentCapture::WriteByte( uint8_t b )
+{
+	bytesWritten += log.write( b );
+}
+
+void X7SegmentCapture::WriteColor( uint32_t col )
+{
+	WriteByte( col >> 16 );
+	WriteByte( col >> 8 );
+	WriteByte( col );
+}
+
+void X7SegmentCapture::Capture( const uint32_t *frame, uint16_t count, uint8_t brightness )
+{
+	uint32_t now = millis();
+
+	// First frame - write the header and start from an all black previous frame
+	if ( previous == NULL )
+	{
+		previous = (uint32_t *) calloc( count, sizeof(uint32_t) );
+		if ( previous == NULL )
+			return;
+
+		ledCount = count;
+		lastMillis = now;
+
+		WriteByte( 'X' );
+		WriteByte( '7' );
+		WriteByte( 'L' );
+		WriteByte( X7SEGMENT_LOG_VERSION );
+		WriteByte( ledCount );
+		WriteByte( ledCount >> 8 );
+	}
+
+	// The log is for a single display, so ignore frames of any other size
+	if ( count != ledCount )
+		return;
+
+	uint32_t delta = now - lastMillis;
+	lastMillis = now;
+
+	do
+	{
+		uint8_t b = delta & 0x7F;
+		delta >>= 7;
+		WriteByte( delta ? ( b | 0x80 ) : b );
+	}
+	while ( delta );
+
+	// Brightness is applied on the way out, so a fade changes it without touching a single LED
+	if ( frameCount == 0 || brightness != lastBrightness )
+	{
+		WriteByte( X7SEGMENT_LOG_BRIGHTNESS );
+		WriteByte( brightness );
+		lastBrightness = brightness;
+	}
+
+	uint16_t i = 0;
+	while ( i < count )
+	{
+		uint16_t run = 1;
+
+		if ( frame[i] == previous[i] )
+		{
+			while ( i + run < count && run < X7SEGMENT_LOG_MAX_RUN && frame[ i + run ] == previous[ i + run ] )
+				run++;
+
+			WriteByte( X7SEGMENT_LOG_SKIP | ( run - 1 ) );
+		}
+		else
+		{
+			while ( i + run < count && run < X7SEGMENT_LOG_MAX_RUN && frame[ i + run ] == frame[i] )
+				run++;
+
+			if ( run > 1 )
+			{
+				WriteByte( X7SEGMENT_LOG_REPEAT | ( run - 1 ) );
+				WriteColor( frame[i] );
+			}
+			else
+			{
+				// Literal run ends where the pixels stop changing, or a repeat starts
+				while ( i + run < count && run < X7SEGMENT_LOG_MAX_RUN && frame[ i + run ] != previous[ i + run ]
+						&& !( i + run + 1 < count && frame[ i + run + 1 ] == frame[ i + run ] ) )
+					run++;
+
+				WriteByte( X7SEGMENT_LOG_LITERAL | ( run - 1 ) );
+				for ( uint16_t p = 0; p < run; p++ )
+					WriteColor( frame[ i + p ] );
+			}
+		}
+
+		i += run;
+	}
+
+	memcpy( previous, frame, count * sizeof(uint32_t) );
+	frameCount++;
+}
+
+
+X7SegmentReplay::X7SegmentReplay( Stream &in ) : log( in )
+{
+	frame = NULL;
+	ledCount = 0;
+	brightness = 255;
+	brightnessChanged = false;
+	frameDelay = 0;
+	playMicros = 0;
+}
+
+X7SegmentReplay::~X7SegmentReplay()
+{
+	free( frame );
+}
+
+const uint32_t *X7SegmentReplay::GetFrame()
+{
+	return frame;
+}
+
+uint8_t X7SegmentReplay::GetBrightness()
+{
+	return brightness;
+}
+
+uint16_t X7SegmentReplay::GetLedCount()
+{
+	return ledCount;
+}
+
+uint32_t X7SegmentReplay::GetFrameDelay()
+{
+	return frameDelay;
+}
+
+uint32_t X7SegmentReplay::GetPlayMicros()
+{
+	return playMicros;
+}
+
+bool X7SegmentReplay::ReadByte( uint8_t &b )
+{
+	int c = log.read();
+	if ( c < 0 )
+		return false;
+
+	b = c;
+	return true;
+}
+
+bool X7SegmentReplay::ReadColor( uint32_t &col )
+{
+	uint8_t r, g, b;
+	if ( !ReadByte( r ) || !ReadByte( g ) || !ReadByte( b ) )
+		return false;
+
+	col = X7Segment::Color( r, g, b );
+	return true;
+}
+
+bool X7SegmentReplay::Begin()
+{
+	uint8_t header[6];
+	for ( uint8_t i = 0; i < 6; i++ )
+	{
+		if ( !ReadByte( header[i] ) )
+			return false;
+	}
+
+	if ( header[0] != 'X' || header[1] != '7' || header[2] != 'L' || header[3] == 0 || header[3] > X7SEGMENT_LOG_VERSION )
+		return false;
+
+	ledCount = header[4] | ( header[5] << 8 );
+
+	free( frame );
+	frame = (uint32_t *) calloc( ledCount, sizeof(uint32_t) );
+
+	return ( frame != NULL );
+}
+
+bool X7SegmentReplay::ReadFrame()
+{
+	if ( frame == NULL )
+		return false;
+
+	uint8_t b;
+	uint8_t shift = 0;
+	frameDelay = 0;
+	brightnessChanged = false;
+
+	do
+	{
+		if ( !ReadByte( b ) || shift > 28 )
+			return false;
+
+		frameDelay |= (uint32_t)( b & 0x7F ) << shift;
+		shift += 7;
+	}
+	while ( b & 0x80 );
+
+	// Tokens are applied on top of the last frame, so anything skipped keeps its color
+	uint16_t i = 0;
+	while ( i < ledCount )
+	{
+		if ( !ReadByte( b ) )
+			return false;
+
+		// Doesn't cover any LEDs, so it is read before the run checks
+		if ( b == X7SEGMENT_LOG_BRIGHTNESS )
+		{
+			if ( !ReadByte( brightness ) )
+				return false;
+
+			brightnessChanged = true;
+			continue;
+		}
+
+		uint16_t run = ( b & 0x3F ) + 1;
+		if ( i + run > ledCount )
+			return false;
+
+		switch( b & 0xC0 )
+		{
+			case X7SEGMENT_LOG_SKIP:
+				break;
+
+			case X7SEGMENT_LOG_REPEAT:
+			{
+				uint32_t col;
+				if ( !ReadColor( col ) )
+					return false;
+
+				for ( uint16_t p = 0; p < run; p++ )
+					frame[ i + p ] = col;
+				break;
+			}
+
+			case X7SEGMENT_LOG_LITERAL:
+				for ( uint16_t p = 0; p < run; p++ )
+				{
+					if ( !ReadColor( frame[ i + p ] ) )
+						return false;
+				}
+				break;
+
+			default:
+				return false;
+		}
+
+		i += run;
+	}
+
+	return true;
+}
+
+uint32_t X7SegmentReplay::Play( X7Segment &display, bool realtime )
+{
+	uint32_t frames = 0;
+
+	if ( display.GetLedCount() != ledCount )
+		return 0;
+
+	uint32_t start = micros();
+
+	while ( ReadFrame() )
+	{
+		if ( realtime )
+			delay( frameDelay );
+
+		if ( brightnessChanged )
+			display.SetBrightness( brightness );
+
+		display.ShowFrame( frame );
+
+		// With the governor on, the frame may be held back until the chain is free - send it before the next one replaces it
+		while ( display.frameDeferred )
+			display.Tick();
+
+		frames++;
+	}
+
+	playMicros = micros() - start;
+
+	return frames;
+}
+
+int32_t X7SegmentReplay::Diff( X7SegmentReplay &other )
+{
+	if ( ledCount != other.GetLedCount() )
+		return 0;
+
+	int32_t index = 0;
+
+	while ( true )
+	{
+		bool more = ReadFrame();
+		bool otherMore = other.ReadFrame();
+
+		if ( !more && !otherMore )
+			return -1;
+
+		if ( more != otherMore || brightness != other.GetBrightness() || memcmp( frame, other.GetFrame(), ledCount * sizeof(uint32_t) ) != 0 )
+			return index;
+
+		index++;
+	}
+}
@@ -0,0 +1,105 @@
+// ---------------------------------------------------------------------------
+// Created by Seon Rozenblum - seon@unexpectedmaker.com
+// Copyright 2019 License: MIT https://github.com/UnexpectedMaker/X7Segment/LICENSE
+//
+// PURPOSE:
+// Capture every frame an X7Segment sends out into a compact log, and replay
+// that log back through a display later. Useful for reproducing a glitch
+// without watching the boards, for benchmarking the output stage, and for
+// comparing the frames two versions of the library produce.
+//
+// LOG FORMAT:
+//   Header: 'X', '7', 'L', version, led count lo, led count hi
+//   Frame : delay in ms since the previous frame (LEB128 varint), then tokens
+//           until every LED in the frame is covered. Each token is one byte,
+//           the top 2 bits are the type and the low 6 bits are count - 1:
+//             00 - skip count LEDs, they are the same as the previous frame
+//             01 - count LEDs are all set to the r, g, b that follow
+//             10 - count LEDs follow as literal r, g, b values
+//             11 - the brightness byte that follows applies from this frame on,
+//                  written on the first frame and whenever the brightness changes
+//
+//   Version 1 logs have no brightness tokens, and are still read back.
+//
+// SYNTAX:
+//   X7SegmentCapture( out )   - Log frames to any Print (SD File, Serial, etc)
+//   disp.SetCapture( &cap )   - Start capturing frames from a display
+//
+//   X7SegmentReplay( in )     - Read a log back from any Stream
+//   Begin()                   - Read the log header
+//   ReadFrame()               - Decode the next frame, returns false at the end of the log
+//   Play( disp, realtime )    - Push every frame and brightness change through a display, at original or maximum speed
+//   Diff( other )             - Index of the first frame that differs between two logs, including brightness, or -1
+// ---------------------------------------------------------------------------
+
+#ifndef X7SegmentCapture_h
+	#define X7SegmentCapture_h
+
+	#include "X7Segment.h"
+
+	#define X7SEGMENT_LOG_VERSION	2
+
+	#define X7SEGMENT_LOG_SKIP		0x00
+	#define X7SEGMENT_LOG_REPEAT	0x40
+	#define X7SEGMENT_LOG_LITERAL	0x80
+	#define X7SEGMENT_LOG_BRIGHTNESS	0xC0
+	#define X7SEGMENT_LOG_MAX_RUN	64
+
+class X7SegmentCapture
+{
+	public:
+		X7SegmentCapture( Print &out );
+		~X7SegmentCapture();
+
+		void Capture( const uint32_t *frame, uint16_t count, uint8_t brightness );
+
+		uint32_t GetFrameCount();
+		uint32_t GetBytesWritten();
+
+	private:
+
+		Print &log;
+		uint32_t *previous;
+		uint16_t ledCount;
+		uint32_t lastMillis;
+		uint8_t lastBrightness;
+		uint32_t frameCount;
+		uint32_t bytesWritten;
+
+		void WriteByte( uint8_t b );
+		void WriteColor( uint32_t col );
+};
+
+class X7SegmentReplay
+{
+	public:
+		X7SegmentReplay( Stream &in );
+		~X7SegmentReplay();
+
+		bool Begin();
+		bool ReadFrame();
+
+		const uint32_t *GetFrame();
+		uint8_t GetBrightness();
+		uint16_t GetLedCount();
+		uint32_t GetFrameDelay();
+
+		uint32_t Play( X7Segment &display, bool realtime );
+		uint32_t GetPlayMicros();
+
+		int32_t Diff( X7SegmentReplay &other );
+
+	private:
+
+		Stream &log;
+		uint32_t *frame;
+		uint16_t ledCount;
+		uint8_t brightness;
+		bool brightnessChanged;
+		uint32_t frameDelay;
+		uint32_t playMicros;
+
+		bool ReadByte( uint8_t &b );
+		bool ReadColor( uint32_t &col );
+};
+#endif
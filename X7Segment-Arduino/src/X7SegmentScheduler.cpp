@@ -0,0 +1,279 @@
+// ---------------------------------------------------------------------------
+// Created by Seon Rozenblum - seon@unexpectedmaker.com
+// Copyright 2019 License: MIT https://github.com/UnexpectedMaker/X7Segment/LICENSE
+//
+// See "X7SegmentScheduler.h" for purpose and syntax.
+// ---------------------------------------------------------------------------
+
+#include "X7SegmentScheduler.h"
+
+X7SegmentScheduler::X7SegmentScheduler( uint8_t channels, uint8_t blocks )
+{
+	displayCount = 0;
+	nextDisplay = 0;
+	skippedDisplay = -1;
+	poolChannels = channels;
+	poolBlocks = blocks;
+	windowStart = 0;
+	windowLength = 0;
+	error = NULL;
+}
+
+// Displays outlive a scheduler that goes out of scope, so they must not keep pointing at it
+X7SegmentScheduler::~X7SegmentScheduler()
+{
+	for ( uint8_t i = 0; i < displayCount; i++ )
+	{
+		Release(i);
+		displays[i]->scheduler = NULL;
+	}
+}
+
+const char *X7SegmentScheduler::GetError()
+{
+	return error;
+}
+
+uint8_t X7SegmentScheduler::GetDisplayCount()
+{
+	return displayCount;
+}
+
+uint8_t X7SegmentScheduler::GetPlannedBlocks( uint8_t index )
+{
+	if ( index >= displayCount )
+		return 0;
+
+	return planned[ index ];
+}
+
+// RMT memory blocks needed to hold a whole frame, capped at the 8 blocks the RMT has.
+// Chains longer than 21 LEDs don't fit in that, so their channel is refilled from led_data while it sends.
+uint8_t X7SegmentScheduler::BlocksForChain( uint16_t ledCount )
+{
+	uint32_t items = 24 * (uint32_t)ledCount;
+	uint32_t needed = ( items + X7SEGMENT_RMT_BLOCK_ITEMS - 1 ) / X7SEGMENT_RMT_BLOCK_ITEMS;
+
+	return max( (uint32_t)1, min( needed, (uint32_t)X7SEGMENT_RMT_BLOCKS ) );
+}
+
+bool X7SegmentScheduler::Add( X7Segment &display )
+{
+	if ( displayCount >= X7SEGMENT_SCHEDULER_MAX_DISPLAYS )
+	{
+		error = "X7SegmentScheduler: too many displays, raise X7SEGMENT_SCHEDULER_MAX_DISPLAYS";
+		return false;
+	}
+
+	if ( poolChannels == 0 || poolBlocks == 0 )
+	{
+		error = "X7SegmentScheduler: the channel pool is empty";
+		return false;
+	}
+
+#if defined(ESP32)
+	// Already started on its own channel, so hand that back to the pool
+	if ( display.rmt_send != NULL )
+	{
+		rmtDeinit( display.rmt_send );
+		display.rmt_send = NULL;
+	}
+#endif
+
+	display.scheduler = this;
+	planned[ displayCount ] = 0;
+	reserved[ displayCount ] = 0;
+	displays[ displayCount++ ] = &display;
+
+	ResizeBlocks();
+
+	return true;
+}
+
+bool X7SegmentScheduler::Remove( X7Segment &display )
+{
+	uint8_t index = 0;
+	while ( index < displayCount && displays[ index ] != &display )
+		index++;
+
+	if ( index == displayCount )
+		return false;
+
+	// Hand its channel back, and close the gap so the rest keep their order
+	Release( index );
+	display.scheduler = NULL;
+	display.framePending = false;
+
+	displayCount--;
+	for ( uint8_t i = index; i < displayCount; i++ )
+	{
+		displays[i] = displays[ i + 1 ];
+		planned[i] = planned[ i + 1 ];
+		reserved[i] = reserved[ i + 1 ];
+	}
+
+	if ( nextDisplay > index )
+		nextDisplay--;
+	if ( nextDisplay >= displayCount )
+		nextDisplay = 0;
+	skippedDisplay = -1;
+
+	if ( displayCount > 0 )
+		ResizeBlocks();
+
+	return true;
+}
+
+// Each display gets what its chain needs, but no more than an even share of the pool
+void X7SegmentScheduler::ResizeBlocks()
+{
+	uint8_t share = max( 1, poolBlocks / displayCount );
+
+	for ( uint8_t i = 0; i < displayCount; i++ )
+		blocks[i] = min( BlocksForChain( displays[i]->ledCount ), share );
+}
+
+// Works out who goes in the next window, without changing whose turn it is
+uint8_t X7SegmentScheduler::Plan()
+{
+	uint8_t channelsLeft = poolChannels;
+	uint8_t blocksLeft = poolBlocks;
+	uint8_t count = 0;
+	skippedDisplay = -1;
+
+	// Start from whoever missed out last time
+	for ( uint8_t n = 0; n < displayCount; n++ )
+	{
+		uint8_t i = ( nextDisplay + n ) % displayCount;
+		planned[i] = 0;
+
+		if ( !displays[i]->framePending || !displays[i]->IsReady() )
+			continue;
+
+		if ( channelsLeft == 0 || blocks[i] > blocksLeft )
+		{
+			if ( skippedDisplay < 0 )
+				skippedDisplay = i;
+			continue;
+		}
+
+		planned[i] = blocks[i];
+		channelsLeft--;
+		blocksLeft -= blocks[i];
+		count++;
+	}
+
+	return count;
+}
+
+bool X7SegmentScheduler::Acquire( uint8_t index )
+{
+#if defined(ESP32)
+	X7Segment *display = displays[ index ];
+
+	if ( display->rmt_send != NULL )
+	{
+		if ( reserved[ index ] == planned[ index ] )
+			return true;
+
+		// Its share of the pool changed since the channel was set up, so set it up again at the new size
+		Release( index );
+	}
+
+	display->rmt_send = rmtInit( display->dispPin, true, (rmt_reserve_memsize_t)planned[ index ] );
+
+	if ( display->rmt_send == NULL )
+	{
+		// Something outside the scheduler is holding RMT memory - the frame stays queued for the next window
+		error = "X7SegmentScheduler: no free RMT channel, is another library using RMT?";
+		return false;
+	}
+
+	reserved[ index ] = planned[ index ];
+	rmtSetTick( display->rmt_send, 100 );
+#else
+	(void)index;
+#endif
+
+	return true;
+}
+
+void X7SegmentScheduler::Release( uint8_t index )
+{
+#if defined(ESP32)
+	X7Segment *display = displays[ index ];
+
+	if ( display->rmt_send != NULL )
+	{
+		rmtDeinit( display->rmt_send );
+		display->rmt_send = NULL;
+	}
+#endif
+
+	reserved[ index ] = 0;
+}
+
+void X7SegmentScheduler::Tick()
+{
+	// Wait for the last window to finish clocking out before touching any channels
+	if ( windowLength > 0 && micros() - windowStart < windowLength )
+		return;
+
+	windowLength = 0;
+
+	if ( Plan() == 0 )
+		return;
+
+#if defined(ESP32)
+	// A channel set up for an older share of the pool, from before displays were added or removed,
+	// holds the wrong amount of RMT memory, so free it before anyone else asks for theirs
+	for ( uint8_t i = 0; i < displayCount; i++ )
+	{
+		if ( planned[i] > 0 && displays[i]->rmt_send != NULL && reserved[i] != planned[i] )
+			Release(i);
+	}
+
+	// Displays keep their channel between windows, and only give it up when someone else needs it
+	bool needChannels = false;
+	for ( uint8_t i = 0; i < displayCount; i++ )
+	{
+		if ( planned[i] > 0 && displays[i]->rmt_send == NULL )
+			needChannels = true;
+	}
+
+	if ( needChannels )
+	{
+		for ( uint8_t i = 0; i < displayCount; i++ )
+		{
+			if ( planned[i] == 0 )
+				Release(i);
+		}
+	}
+#endif
+
+	windowStart = micros();
+
+	for ( uint8_t i = 0; i < displayCount; i++ )
+	{
+		if ( planned[i] == 0 )
+			continue;
+
+		// Couldn't get a channel, so it counts as skipped and goes first next time if nobody earlier was
+		if ( !Acquire(i) )
+		{
+			uint8_t turn = ( i + displayCount - nextDisplay ) % displayCount;
+			if ( skippedDisplay < 0 || turn < ( skippedDisplay + displayCount - nextDisplay ) % displayCount )
+				skippedDisplay = i;
+			continue;
+		}
+
+		displays[i]->SendBuffer();
+		displays[i]->framePending = false;
+
+		windowLength = max( windowLength, displays[i]->GetFrameMicros() );
+	}
+
+	// Start from whoever missed out this time, so nobody waits forever
+	if ( skippedDisplay >= 0 )
+		nextDisplay = skippedDisplay;
+}
@@ -0,0 +1,79 @@
+// ---------------------------------------------------------------------------
+// Created by Seon Rozenblum - seon@unexpectedmaker.com
+// Copyright 2019 License: MIT https://github.com/UnexpectedMaker/X7Segment/LICENSE
+//
+// PURPOSE:
+// Share the ESP32's RMT channels between more X7Segment displays than there
+// are channels. Displays added to a scheduler don't send frames themselves,
+// they are queued and the scheduler sends them together in one transmit
+// window per Tick(), handing out channels and RMT memory as it goes.
+//
+// Each display is given RMT memory blocks to suit its chain length, limited
+// to a fair share of the pool. If there are more waiting displays than fit
+// in one window, the rest go first in the next window.
+//
+// SYNTAX:
+//   X7SegmentScheduler( channels, blocks ) - Size of the channel pool, defaults to the ESP32's 8 channels and 8 blocks
+//   Add( display )                         - Add a display, must be called before the display's Begin()
+//   Remove( display )                      - Take a display off the scheduler, done for you when the display is destroyed
+//   Tick()                                 - Call every loop(), sends waiting frames once the last window has finished
+//   GetError()                             - Description of the last problem, or NULL
+//
+//   Plan() and GetPlannedBlocks() are the scheduling decisions on their own, with no
+//   hardware involved and no change to whose turn it is, so they can be checked
+//   against a made up pool on any board.
+// ---------------------------------------------------------------------------
+
+#ifndef X7SegmentScheduler_h
+	#define X7SegmentScheduler_h
+
+	#include "X7Segment.h"
+
+	#ifndef X7SEGMENT_SCHEDULER_MAX_DISPLAYS
+		#define X7SEGMENT_SCHEDULER_MAX_DISPLAYS 16
+	#endif
+
+	#define X7SEGMENT_RMT_CHANNELS		8
+	#define X7SEGMENT_RMT_BLOCKS		8
+	#define X7SEGMENT_RMT_BLOCK_ITEMS	64
+
+class X7SegmentScheduler
+{
+	public:
+		X7SegmentScheduler( uint8_t channels = X7SEGMENT_RMT_CHANNELS, uint8_t blocks = X7SEGMENT_RMT_BLOCKS );
+		~X7SegmentScheduler();
+
+		bool Add( X7Segment &display );
+		bool Remove( X7Segment &display );
+		void Tick();
+
+		uint8_t Plan();
+		uint8_t GetPlannedBlocks( uint8_t index );
+		uint8_t GetDisplayCount();
+		const char *GetError();
+
+		static uint8_t BlocksForChain( uint16_t ledCount );
+
+	private:
+
+		X7Segment *displays[ X7SEGMENT_SCHEDULER_MAX_DISPLAYS ];
+		uint8_t blocks[ X7SEGMENT_SCHEDULER_MAX_DISPLAYS ];
+		uint8_t planned[ X7SEGMENT_SCHEDULER_MAX_DISPLAYS ];
+		uint8_t reserved[ X7SEGMENT_SCHEDULER_MAX_DISPLAYS ];
+		uint8_t displayCount;
+		uint8_t nextDisplay;
+		int16_t skippedDisplay;
+
+		uint8_t poolChannels;
+		uint8_t poolBlocks;
+
+		uint32_t windowStart;
+		uint32_t windowLength;
+
+		const char *error;
+
+		void ResizeBlocks();
+		bool Acquire( uint8_t index );
+		void Release( uint8_t index );
+};
+#endif
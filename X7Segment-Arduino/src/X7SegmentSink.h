@@ -0,0 +1,32 @@
+// ---------------------------------------------------------------------------
+// Created by Seon Rozenblum - seon@unexpectedmaker.com
+// Copyright 2019 License: MIT https://github.com/UnexpectedMaker/X7Segment/LICENSE
+//
+// PURPOSE:
+// Where X7SegmentStream puts the packets it decodes. X7Segment is a sink, and
+// anything else that implements these four calls can be fed by the parser too,
+// which lets the parser be built and tested on its own with no Arduino core.
+//
+// SYNTAX:
+//   GetDisplayCount()                   - Number of digits a full frame covers
+//   SetDigit( index, segments, color )  - Set one digit's segment bits and color, bit 7 is the decimal point
+//   SetBrightness( brightness )         - Set the output brightness
+//   Show()                              - Send what has been set
+// ---------------------------------------------------------------------------
+
+#ifndef X7SegmentSink_h
+	#define X7SegmentSink_h
+
+	#include <stdint.h>
+
+class X7SegmentSink
+{
+	public:
+		virtual ~X7SegmentSink() {}
+
+		virtual uint8_t GetDisplayCount() = 0;
+		virtual void SetDigit( uint8_t index, uint8_t segments, uint32_t color ) = 0;
+		virtual void SetBrightness( uint8_t brightness ) = 0;
+		virtual void Show() = 0;
+};
+#endif
@@ -0,0 +1,233 @@
+// ---------------------------------------------------------------------------
+// Created by Seon Rozenblum - seon@unexpectedmaker.com
+// Copyright 2019 License: MIT https://github.com/UnexpectedMaker/X7Segment/LICENSE
+//
+// See "X7SegmentStream.h" for purpose, packet format and syntax.
+// ---------------------------------------------------------------------------
+
+#include "X7SegmentStream.h"
+#include <stdlib.h>
+
+#define RING_MASK ( ringSize - 1 )
+
+// Sync byte, command, 2 length bytes and the trailing crc
+#define PACKET_OVERHEAD 5
+
+X7SegmentStream::X7SegmentStream( X7SegmentSink &sink ) : disp( sink )
+{
+	head = 0;
+	tail = 0;
+	packetCount = 0;
+	errorCount = 0;
+	oversizeCount = 0;
+
+	// Big enough for a delta frame that changes every digit, rounded up to a power of 2 for the ring mask
+	uint16_t needed = disp.GetDisplayCount() * 5 + PACKET_OVERHEAD;
+	ringSize = X7SEGMENT_STREAM_BUFFER;
+	while ( ringSize < needed )
+		ringSize <<= 1;
+
+	ring = (uint8_t *) malloc( ringSize );
+	if ( ring == NULL )
+		ringSize = 0;
+}
+
+X7SegmentStream::~X7SegmentStream()
+{
+	free( ring );
+}
+
+uint16_t X7SegmentStream::Available()
+{
+	// head and tail free run, so the difference is the fill level even after they wrap
+	return (uint16_t)( head - tail );
+}
+
+uint16_t X7SegmentStream::GetBufferSize()
+{
+	return ringSize;
+}
+
+uint32_t X7SegmentStream::GetPacketCount()
+{
+	return packetCount;
+}
+
+uint32_t X7SegmentStream::GetErrorCount()
+{
+	return errorCount;
+}
+
+uint32_t X7SegmentStream::GetOversizeCount()
+{
+	return oversizeCount;
+}
+
+uint8_t X7SegmentStream::Peek( uint16_t offset )
+{
+	return ring[ ( tail + offset ) & RING_MASK ];
+}
+
+void X7SegmentStream::Drop( uint16_t count )
+{
+	tail += count;
+}
+
+uint8_t X7SegmentStream::Crc8( uint8_t crc, uint8_t data )
+{
+	crc ^= data;
+	for ( uint8_t i = 0; i < 8; i++ )
+		crc = ( crc & 0x80 ) ? ( crc << 1 ) ^ 0x07 : ( crc << 1 );
+
+	return crc;
+}
+
+size_t X7SegmentStream::Write( const uint8_t *data, size_t len )
+{
+	size_t written = 0;
+
+	while ( written < len && Available() < ringSize )
+		ring[ head++ & RING_MASK ] = data[ written++ ];
+
+	return written;
+}
+
+#if defined(ARDUINO)
+uint16_t X7SegmentStream::Poll( Stream &stream )
+{
+	uint16_t applied = 0;
+
+	if ( ring == NULL )
+		return 0;
+
+	while ( stream.available() > 0 )
+	{
+		// Buffer is full, so make room by applying what we have before reading more
+		if ( Available() == ringSize )
+			applied += Process();
+
+		ring[ head++ & RING_MASK ] = stream.read();
+	}
+
+	return applied + Process();
+}
+#endif
+
+uint16_t X7SegmentStream::Process()
+{
+	uint16_t applied = 0;
+
+	while ( Available() > 0 )
+	{
+		// Throw away anything that isn't the start of a packet
+		if ( Peek(0) != X7SEGMENT_STREAM_SYNC )
+		{
+			Drop(1);
+			errorCount++;
+			continue;
+		}
+
+		if ( Available() < PACKET_OVERHEAD )
+			break;
+
+		uint16_t len = Peek(2) | ( Peek(3) << 8 );
+
+		// A packet that can never fit in the buffer can't be checked, so drop the sync byte and look for the next one
+		if ( len > ringSize - PACKET_OVERHEAD )
+		{
+			Drop(1);
+			oversizeCount++;
+			continue;
+		}
+
+		// Wait for the rest of the packet to arrive
+		if ( Available() < len + PACKET_OVERHEAD )
+			break;
+
+		uint8_t crc = 0;
+		for ( uint16_t i = 1; i < len + 4; i++ )
+			crc = Crc8( crc, Peek(i) );
+
+		if ( crc != Peek( len + 4 ) )
+		{
+			Drop(1);
+			errorCount++;
+			continue;
+		}
+
+		if ( Apply( Peek(1), len ) )
+		{
+			packetCount++;
+			applied++;
+		}
+		else
+		{
+			errorCount++;
+		}
+
+		Drop( len + PACKET_OVERHEAD );
+	}
+
+	return applied;
+}
+
+// Packed r, g, b starting at offset, the same as X7Segment::Color()
+uint32_t X7SegmentStream::Color( uint16_t offset )
+{
+	return ( (uint32_t)Peek( offset ) << 16 ) | ( (uint32_t)Peek( offset + 1 ) << 8 ) | Peek( offset + 2 );
+}
+
+bool X7SegmentStream::Apply( uint8_t cmd, uint16_t len )
+{
+	// The payload is decoded straight out of the ring buffer into the display, nothing is copied out first
+	uint16_t p = 4;
+
+	switch( cmd )
+	{
+		case X7SEGMENT_STREAM_FRAME:
+		{
+			if ( len % 4 != 0 )
+				return false;
+
+			uint16_t digits = len / 4;
+			for ( uint16_t d = 0; d < disp.GetDisplayCount(); d++ )
+			{
+				if ( d < digits )
+				{
+					disp.SetDigit( d, Peek(p), Color( p + 1 ) );
+					p += 4;
+				}
+				else
+				{
+					disp.SetDigit( d, 0, 0 );
+				}
+			}
+			disp.Show();
+			return true;
+		}
+
+		case X7SEGMENT_STREAM_DELTA:
+		{
+			if ( len % 5 != 0 )
+				return false;
+
+			for ( ; p < len + 4; p += 5 )
+				disp.SetDigit( Peek(p), Peek(p+1), Color( p + 2 ) );
+
+			disp.Show();
+			return true;
+		}
+
+		case X7SEGMENT_STREAM_BRIGHTNESS:
+		{
+			if ( len != 1 )
+				return false;
+
+			disp.SetBrightness( Peek(p) );
+			disp.Show();
+			return true;
+		}
+	}
+
+	return false;
+}
@@ -0,0 +1,96 @@
+// ---------------------------------------------------------------------------
+// Created by Seon Rozenblum - seon@unexpectedmaker.com
+// Copyright 2019 License: MIT https://github.com/UnexpectedMaker/X7Segment/LICENSE
+//
+// PURPOSE:
+// Binary frame streaming for X7Segment displays, so a host can drive the
+// boards over any Arduino Stream (Serial, WiFiClient, etc) without the sketch
+// having to build Strings for every frame.
+//
+// PACKET FORMAT:
+//   [ 0xA5 ][ cmd ][ len lo ][ len hi ][ payload ... ][ crc8 ]
+//
+//   crc8 is CRC-8 (poly 0x07, init 0x00) over cmd, both len bytes and the payload.
+//
+//   cmd 0x01 - Full frame : N x { segments, r, g, b } for digits 0 to N-1, other digits are cleared
+//   cmd 0x02 - Delta frame: N x { digit, segments, r, g, b }, only the listed digits change
+//   cmd 0x03 - Brightness : { brightness }
+//
+//   Segment bits are the same as the character codes in X7Segment.cpp, bit 7 is the decimal point.
+//
+// BUFFER SIZE:
+//   A packet has to fit in the ring buffer whole, so the buffer is sized when the
+//   parser is created, to hold a delta frame that changes every digit of the sink.
+//   It is never smaller than X7SEGMENT_STREAM_BUFFER. Packets that could never fit
+//   are dropped and counted by GetOversizeCount(), rather than as sync errors.
+//
+// SYNTAX:
+//   X7SegmentStream( sink )    - Attach a parser to an initialised X7Segment, or any other X7SegmentSink
+//   Poll( stream )             - Pull any available bytes from an Arduino Stream and apply complete packets
+//   Write( data, len )         - Push bytes in from any other source, returns how many fit in the buffer
+//   Process()                  - Apply complete packets that are sitting in the buffer
+//
+//   The parser only needs X7SegmentSink.h, so it builds without the Arduino core for
+//   fuzzing and throughput tests on a host - see extras/host/stream_pipe.cpp.
+// ---------------------------------------------------------------------------
+
+#ifndef X7SegmentStream_h
+	#define X7SegmentStream_h
+
+	#include <stdint.h>
+	#include <stddef.h>
+	#include "X7SegmentSink.h"
+
+	#if defined(ARDUINO)
+		#include <Arduino.h>
+	#endif
+
+	// Smallest the receive ring buffer can be - must be a power of 2
+	#ifndef X7SEGMENT_STREAM_BUFFER
+		#define X7SEGMENT_STREAM_BUFFER 256
+	#endif
+
+	#define X7SEGMENT_STREAM_SYNC			0xA5
+	#define X7SEGMENT_STREAM_FRAME			0x01
+	#define X7SEGMENT_STREAM_DELTA			0x02
+	#define X7SEGMENT_STREAM_BRIGHTNESS		0x03
+
+class X7SegmentStream
+{
+	public:
+		X7SegmentStream( X7SegmentSink &sink );
+		~X7SegmentStream();
+
+	#if defined(ARDUINO)
+		uint16_t Poll( Stream &stream );
+	#endif
+		size_t Write( const uint8_t *data, size_t len );
+		uint16_t Process();
+
+		uint16_t Available();
+		uint16_t GetBufferSize();
+		uint32_t GetPacketCount();
+		uint32_t GetErrorCount();
+		uint32_t GetOversizeCount();
+
+		static uint8_t Crc8( uint8_t crc, uint8_t data );
+
+	private:
+
+		X7SegmentSink &disp;
+
+		uint8_t *ring;
+		uint16_t ringSize;
+		uint16_t head;
+		uint16_t tail;
+
+		uint32_t packetCount;
+		uint32_t errorCount;
+		uint32_t oversizeCount;
+
+		uint8_t Peek( uint16_t offset );
+		uint32_t Color( uint16_t offset );
+		void Drop( uint16_t count );
+		bool Apply( uint8_t cmd, uint16_t len );
+};
+#endif